@@ -25,6 +25,7 @@
 
 // Rendering includes
 #include "src/rendering/core/shader_class.h"
+#include "src/rendering/core/shader_registry.h"
 #include "src/rendering/core/glad_helpers.h"
 #include "src/rendering/core/glfw_helpers.h"
 #include "src/rendering/camera/camera.h"
@@ -107,7 +108,8 @@ bool handleWindowStateTransitions(GLFWwindow* window, WindowState& state)
 }
 
 // Performance monitoring update
-void updatePerformanceMonitoring(PerformanceMonitor& perfMonitor, UIManager& uiManager, float deltaTime, float currentFrame)
+void updatePerformanceMonitoring(PerformanceMonitor& perfMonitor, UIManager& uiManager, const CellManager& previewCellManager,
+	const CellManager& mainCellManager, float deltaTime, float currentFrame)
 {
 	perfMonitor.frameCount++;
 	perfMonitor.frameTimeAccumulator += deltaTime;
@@ -121,6 +123,17 @@ void updatePerformanceMonitoring(PerformanceMonitor& perfMonitor, UIManager& uiM
 		perfMonitor.frameCount = 0;
 		perfMonitor.frameTimeAccumulator = 0.0f;
 		perfMonitor.lastPerfUpdate = currentFrame;
+
+		// Exact bytes held by every simulation (keyframe builder included), next to what the driver reports (if it reports anything)
+		size_t simulationBytes = previewCellManager.bufferArena.getTotalBytes() + mainCellManager.bufferArena.getTotalBytes();
+		if (const CellManager* keyframeCellManager = uiManager.getKeyframeCellManager())
+			simulationBytes += keyframeCellManager->bufferArena.getTotalBytes();
+		perfMonitor.gpuMemoryUsed = simulationBytes / (1024.0f * 1024.0f);
+		GPUMemoryInfo memoryInfo;
+		perfMonitor.gpuMemoryReported = queryGPUMemoryInfo(memoryInfo);
+		perfMonitor.gpuMemoryTotal = memoryInfo.totalBytes / (1024.0f * 1024.0f);
+		perfMonitor.gpuMemoryAvailable = memoryInfo.availableBytes / (1024.0f * 1024.0f);
+		perfMonitor.gpuMemorySource = memoryInfo.source;
 	}
 }
 
@@ -189,19 +202,22 @@ void renderFrame(CellManager& previewCellManager, CellManager& mainCellManager,
 		// Render the active simulation with its camera
 		try
 		{
-			activeCellManager->renderCells(glm::vec2(width, height), sphereShader, *activeCamera, uiManager.wireframeMode);
+			// Camera, frustum, LOD and selection constants shared by every render pass below
+			activeCellManager->updateFrameConstants(glm::vec2(width, height), *activeCamera);
+
+			activeCellManager->renderCells(glm::vec2(width, height), sphereShader, uiManager.wireframeMode);
 			checkGLError("renderCells");
 			
 			// Render gizmos if enabled
-			activeCellManager->renderGizmos(glm::vec2(width, height), *activeCamera, uiManager.showOrientationGizmos);
+			activeCellManager->renderGizmos(uiManager.showOrientationGizmos);
 			checkGLError("renderGizmos");
 			
 			// Render ring gizmos if enabled
-			activeCellManager->renderRingGizmos(glm::vec2(width, height), *activeCamera, uiManager);
+			activeCellManager->renderRingGizmos(uiManager);
 			checkGLError("renderRingGizmos");
 			
 			// Render adhesionSettings lines if enabled
-			activeCellManager->renderAdhesionLines(glm::vec2(width, height), *activeCamera, uiManager.showAdhesionLines);
+			activeCellManager->renderAdhesionLines(uiManager.showAdhesionLines);
 			checkGLError("renderAdhesionLines");
 		}
 		catch (const std::exception &e)
@@ -234,7 +250,7 @@ void renderFrame(CellManager& previewCellManager, CellManager& mainCellManager,
 	}
 }
 
-void updateSimulation(CellManager& previewCellManager, CellManager& mainCellManager, SceneManager& sceneManager)
+void updateSimulation(CellManager& previewCellManager, CellManager& mainCellManager, SceneManager& sceneManager, UIManager& uiManager)
 {
 	// Only update simulations if not paused
 	if (sceneManager.isPaused())
@@ -258,9 +274,21 @@ void updateSimulation(CellManager& previewCellManager, CellManager& mainCellMana
 		}
 		else if (currentScene == Scene::MainSimulation)
 		{
+			// A trajectory being played back replaces the main simulation (see the main loop)
+			if (uiManager.trajectoryPlayer.isOpen())
+			{
+				return;
+			}
+			
 			// Update only Main Simulation
 			mainCellManager.updateCells(timeStep);
 			checkGLError("updateCells - main");
+			
+			// Update main simulation time tracking
+			sceneManager.updateMainSimulationTime(timeStep);
+			
+			// Capture a trajectory frame if recording (asynchronous, never waits on the GPU)
+			uiManager.trajectoryRecorder.onTick(mainCellManager, sceneManager.getMainSimulationTime());
 		}
 	}
 	catch (const std::exception& e)
@@ -307,6 +335,9 @@ int main()
 	GLFWwindow *window = createWindow();
 	initGLAD(window);
 	setupGLFWDebugFlags();
+	// GLSL versions of the shared GPU structs and constant blocks, registered before any shader includes them
+	register_shader_include("gpu_structs.glsl", GPU_STRUCTS_GLSL);
+	register_shader_include("gpu_constants.glsl", GPU_CONSTANTS_GLSL);
 	// Load the sphere shader for instanced rendering
     Shader sphereShader("shaders/rendering/sphere/sphere.vert", "shaders/rendering/sphere/sphere.frag");
 
@@ -336,6 +367,10 @@ int main()
 	previewCellManager.updateCells(config::physicsTimeStep);
 	mainCellManager.updateCells(config::physicsTimeStep);
 
+	std::cout << "Shader programs: " << ShaderRegistry::instance().getCompiledCount() << " compiled, "
+		<< ShaderRegistry::instance().getCacheHitCount() << " loaded from binary cache, "
+		<< ShaderRegistry::instance().getSharedCount() << " shared\n";
+
 	AudioEngine audioEngine;
 	audioEngine.init();
 	audioEngine.start();
@@ -376,7 +411,12 @@ int main()
 			continue;
 		}
 		// Update performance metrics for min/avg/max calculations and history
-		updatePerformanceMonitoring(perfMonitor, uiManager, deltaTime, currentFrame);
+		updatePerformanceMonitoring(perfMonitor, uiManager, previewCellManager, mainCellManager, deltaTime, currentFrame);
+
+		if (config::SHADER_HOT_RELOAD)
+		{
+			ShaderRegistry::instance().pollHotReload();
+		}
 
 		// Use the valid dimensions we stored
 		int width = windowState.lastKnownWidth;
@@ -420,9 +460,15 @@ int main()
 		/// Then we handle cell simulation
 		while (accumulator >= tickPeriod)
 		{
-			updateSimulation(previewCellManager, mainCellManager, sceneManager);
+			updateSimulation(previewCellManager, mainCellManager, sceneManager, uiManager);
 			accumulator -= tickPeriod;
 		}
+		// Trajectory playback runs at the frame rate, independent of the physics tick rate
+		if (uiManager.trajectoryPlayer.isOpen() && sceneManager.getCurrentScene() == Scene::MainSimulation)
+		{
+			float playbackDelta = sceneManager.isPaused() ? 0.0f : deltaTime * sceneManager.getSimulationSpeed();
+			uiManager.trajectoryPlayer.update(mainCellManager, playbackDelta);
+		}
 		/// Then we handle rendering
 		renderFrame(previewCellManager, mainCellManager, previewCamera, mainCamera, uiManager, sphereShader, perfMonitor, sceneManager, width, height);
 
@@ -465,6 +511,8 @@ int main()
 			}
 		}
 	}
+	// The trajectory ring lives in mainCellManager's buffer arena, which is destroyed before uiManager
+	uiManager.trajectoryRecorder.stop();
 	}
 	// destroy and terminate everything before ending the ID
 	shutdownImGui();
@@ -0,0 +1,7 @@
+// Per-instance data written by unified_cull.comp and read by the sphere, impostor and ring gizmo shaders
+struct InstanceData {
+    vec4 positionAndRadius;  // xyz = position, w = radius
+    vec4 color;              // rgba color
+    vec4 orientation;        // quaternion (w, x, y, z)
+    vec4 fadeFactor;         // x = distance-based fade factor, y = source cell index, zw = padding
+};
@@ -0,0 +1,52 @@
+// Spatial grid helpers shared by the grid and physics shaders.
+// Grid settings come from the SimulationConstants block.
+#include "gpu_constants.glsl"
+
+// Function to convert world position to grid coordinates
+ivec3 worldToGrid(vec3 worldPos) {
+    // Clamp to world bounds first
+    vec3 clampedPos = clamp(worldPos, vec3(-u_worldSize * 0.5), vec3(u_worldSize * 0.5));
+    
+    // Convert to grid coordinates [0, gridResolution)
+    vec3 normalizedPos = (clampedPos + u_worldSize * 0.5) / u_worldSize;
+    ivec3 gridPos = ivec3(normalizedPos * u_gridResolution);
+    
+    // Ensure we stay within bounds
+    return clamp(gridPos, ivec3(0), ivec3(u_gridResolution - 1));
+}
+
+// Function to convert 3D grid coordinates to 1D index
+uint gridToIndex(ivec3 gridPos) {
+    return uint(gridPos.x + gridPos.y * u_gridResolution + gridPos.z * u_gridResolution * u_gridResolution);
+}
+
+// Function to check if grid coordinates are valid
+bool isValidGridPos(ivec3 gridPos) {
+    return gridPos.x >= 0 && gridPos.x < u_gridResolution &&
+           gridPos.y >= 0 && gridPos.y < u_gridResolution &&
+           gridPos.z >= 0 && gridPos.z < u_gridResolution;
+}
+
+// First grid cell of ensemble simulation `simulationId`'s block (see SimulationEnsemble)
+ivec3 simulationBlockStart(int simulationId) {
+    int side = u_ensembleLatticeSide;
+    ivec3 block = ivec3(simulationId % side, (simulationId / side) % side, simulationId / (side * side));
+    return block * u_ensembleBlockCells;
+}
+
+// World-space bounds of simulation `simulationId`'s block
+void simulationBlockBounds(int simulationId, out vec3 blockMin, out vec3 blockMax) {
+    blockMin = vec3(-u_worldSize * 0.5) + vec3(simulationBlockStart(simulationId)) * u_gridCellSize;
+    blockMax = blockMin + vec3(float(u_ensembleBlockCells) * u_gridCellSize);
+}
+
+// Grid cell of a cell; ensemble simulations only ever use the grid cells of their own block,
+// so they never compete for the slots of a shared grid cell
+ivec3 cellToGrid(vec3 worldPos, int simulationId) {
+    ivec3 gridPos = worldToGrid(worldPos);
+    if (u_ensembleLatticeSide > 0) {
+        ivec3 blockStart = simulationBlockStart(simulationId);
+        gridPos = clamp(gridPos, blockStart, blockStart + ivec3(u_ensembleBlockCells - 1));
+    }
+    return gridPos;
+}
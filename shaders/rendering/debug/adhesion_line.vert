@@ -1,15 +1,30 @@
 #version 430 core
 
-layout (location = 0) in vec4 aPosition;
-layout (location = 1) in vec4 aColor;
+// Adhesion lines, pulled straight from the connection and cell buffers.
+// Each connection generates one line (2 vertices), drawn as GL_LINES.
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+#include "gpu_structs.glsl"
+
+// Input: Cell data
+layout(std430, binding = 0) readonly buffer CellBuffer {
+    ComputeCell cells[];
+};
+
+// Input: Adhesion connections
+layout(std430, binding = 1) readonly buffer AdhesionConnectionBuffer {
+    AdhesionConnection connections[];
+};
+
+#include "gpu_constants.glsl"
 
 out vec4 vColor;
 
 void main()
 {
-    vColor = aColor;
-    gl_Position = uProjection * uView * aPosition;
-} 
\ No newline at end of file
+    AdhesionConnection connection = connections[gl_VertexID / 2];
+    uint cellIndex = (gl_VertexID & 1) == 0 ? connection.cellAIndex : connection.cellBIndex;
+
+    // Use a distinctive color for adhesion lines (orange/amber)
+    vColor = vec4(1.0, 0.6, 0.2, 1.0);
+    gl_Position = uProjection * uView * vec4(cells[cellIndex].positionAndMass.xyz, 1.0);
+}
@@ -1,14 +1,59 @@
 #version 430 core
 
-layout(location = 0) in vec4 aPosition;
-layout(location = 1) in vec4 aColor;
+// Orientation gizmo lines, pulled straight from the cell buffer.
+// Each cell generates 6 vertices (3 lines, 2 vertices each), drawn as GL_LINES.
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+#include "gpu_structs.glsl"
+
+// Input: Cell data
+layout(std430, binding = 0) readonly buffer CellBuffer {
+    ComputeCell cells[];
+};
+
+#include "gpu_constants.glsl"
 
 out vec3 vColor;
 
+// Convert quaternion to rotation matrix
+mat3 quatToMat3(vec4 quat) {
+    float x = quat.x, y = quat.y, z = quat.z, w = quat.w;
+    float x2 = x + x, y2 = y + y, z2 = z + z;
+    float xx = x * x2, xy = x * y2, xz = x * z2;
+    float yy = y * y2, yz = y * z2, zz = z * z2;
+    float wx = w * x2, wy = w * y2, wz = w * z2;
+
+    return mat3(
+        1.0 - (yy + zz), xy + wz, xz - wy,
+        xy - wz, 1.0 - (xx + zz), yz + wx,
+        xz + wy, yz - wx, 1.0 - (xx + yy)
+    );
+}
+
+// Axis colors: local X (blue), local Y (green), local Z (red)
+const vec3 axisColors[3] = vec3[3](
+    vec3(0.0, 0.0, 1.0),
+    vec3(0.0, 1.0, 0.0),
+    vec3(1.0, 0.0, 0.0)
+);
+
 void main() {
-    vColor = aColor.rgb;
-    gl_Position = uProjection * uView * aPosition;
-} 
\ No newline at end of file
+    int cellIndex = gl_VertexID / 6;
+    int localIndex = gl_VertexID % 6;
+    int axis = localIndex / 2;        // Which of the 3 lines
+    bool isTip = (localIndex & 1) == 1; // Line start (cell center) or tip
+
+    vec3 cellPos = cells[cellIndex].positionAndMass.xyz;
+    float cellRadius = pow(cells[cellIndex].positionAndMass.w, 1.0/3.0);
+
+    // Calculate gizmo length based on cell size
+    float gizmoLength = cellRadius * 1.8; // 1.8x the cell radius
+
+    // Column of the rotation matrix is the local axis in world space
+    mat3 rotMatrix = quatToMat3(cells[cellIndex].orientation);
+    vec3 worldAxis = rotMatrix[axis];
+
+    vec3 worldPos = isTip ? cellPos + worldAxis * gizmoLength : cellPos;
+
+    vColor = axisColors[axis];
+    gl_Position = uProjection * uView * vec4(worldPos, 1.0);
+}
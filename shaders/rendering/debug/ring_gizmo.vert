@@ -1,14 +1,88 @@
 #version 430 core
 
-layout(location = 0) in vec4 aPosition;
-layout(location = 1) in vec4 aColor;
+// Split-plane ring gizmos, built from a shared instanced ring template.
+// Each instance is one cell; the template (2 rings * 32 segments * 6 vertices) is placed
+// using the cell orientation from the cell buffer and the split direction from the mode buffer.
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout(location = 0) in vec4 aTemplate; // x = cos(angle), y = sin(angle), z = outer edge (0/1), w = second ring (0/1)
+
+#include "gpu_structs.glsl"
+
+// Input: Cell data
+layout(std430, binding = 0) readonly buffer CellBuffer {
+    ComputeCell cells[];
+};
+
+// Input: Mode data
+layout(std430, binding = 1) readonly buffer ModeBuffer {
+    GPUMode modes[];
+};
+
+#include "instance_data.glsl"
+
+// Input: Visible cells from the unified culling pass
+layout(std430, binding = 2) readonly buffer VisibleInstanceBuffer {
+    InstanceData visibleInstances[];
+};
+
+#include "gpu_constants.glsl"
+
+uniform int uCellIndexOverride = -1; // >= 0: draw this cell instead of reading the visible instance list
+uniform int uSkipCellIndex = -1;     // Cell left out of the visible instance list (the selected cell, drawn on its own)
 
 out vec3 vColor;
 
+// Convert quaternion to rotation matrix
+mat3 quatToMat3(vec4 quat) {
+    float x = quat.x, y = quat.y, z = quat.z, w = quat.w;
+    float x2 = x + x, y2 = y + y, z2 = z + z;
+    float xx = x * x2, xy = x * y2, xz = x * z2;
+    float yy = y * y2, yz = y * z2, zz = z * z2;
+    float wx = w * x2, wy = w * y2, wz = w * z2;
+
+    return mat3(
+        1.0 - (yy + zz), xy + wz, xz - wy,
+        xy - wz, 1.0 - (xx + zz), yz + wx,
+        xz + wy, yz - wx, 1.0 - (xx + yy)
+    );
+}
+
 void main() {
-    vColor = aColor.rgb;
-    gl_Position = uProjection * uView * aPosition;
-} 
\ No newline at end of file
+    int cellIndex = uCellIndexOverride >= 0 ? uCellIndexOverride
+                                            : int(visibleInstances[gl_InstanceID].fadeFactor.y);
+    if (uCellIndexOverride < 0 && cellIndex == uSkipCellIndex) {
+        // Collapse every triangle of this instance to a point, the rasterizer drops them
+        vColor = vec3(0.0);
+        gl_Position = vec4(0.0);
+        return;
+    }
+    bool isSecondRing = aTemplate.w > 0.5;
+
+    ComputeCell cell = cells[cellIndex];
+    vec3 cellPos = cell.positionAndMass.xyz;
+    float cellRadius = pow(cell.positionAndMass.w, 1.0/3.0);
+
+    // Transform split direction to world space using cell orientation
+    vec3 splitDirection = normalize(modes[cell.genomeOffset + cell.modeIndex].splitDirection.xyz);
+    vec3 worldSplitDirection = quatToMat3(cell.orientation) * splitDirection;
+
+    // Calculate ring dimensions based on cell size
+    float outerRadius = cellRadius * 1.2;
+    float innerRadius = cellRadius * 1.4;
+
+    // Small offset along the split direction to prevent z-fighting between the two rings
+    float offsetDistance = 0.001;
+    vec3 ringCenter = cellPos + worldSplitDirection * (isSecondRing ? -offsetDistance : offsetDistance);
+
+    // Calculate perpendicular vectors to create the ring plane
+    vec3 up = vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(worldSplitDirection, up));
+    up = normalize(cross(right, worldSplitDirection));
+
+    float radius = aTemplate.z > 0.5 ? outerRadius : innerRadius;
+    vec3 worldPos = ringCenter + (right * aTemplate.x + up * aTemplate.y) * radius;
+
+    // The first ring is drawn red and the second blue
+    vColor = isSecondRing ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    gl_Position = uProjection * uView * vec4(worldPos, 1.0);
+}
@@ -10,10 +10,8 @@ in vec2 vUV;
 
 out vec4 fragColor;
 
-uniform vec3 uLightDir = vec3(1.0, 1.0, 1.0);
-uniform vec3 uSelectedCellPos = vec3(-9999.0); // Position of selected cell, invalid position by default
-uniform float uSelectedCellRadius = 0.0;
-uniform float uTime = 0.0; // For animation effects
+#include "gpu_constants.glsl"
+
 uniform sampler2D uTexture;
 
 void main() {
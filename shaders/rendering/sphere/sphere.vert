@@ -7,9 +7,7 @@ layout(location = 3) in vec4 aPositionAndRadius; // x, y, z, radius
 layout(location = 4) in vec4 aColor;             // r, g, b, unused
 layout(location = 5) in vec4 aOrientation;       // quaternion: w, x, y, z
 
-uniform mat4 uProjection;
-uniform mat4 uView;
-uniform vec3 uCameraPos;
+#include "gpu_constants.glsl"
 
 out vec3 vWorldPos;
 out vec3 vNormal;
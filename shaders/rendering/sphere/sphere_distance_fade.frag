@@ -10,11 +10,7 @@ in float vFadeFactor;
 
 out vec4 fragColor;
 
-uniform vec3 uLightDir = vec3(1.0, 1.0, 1.0);
-uniform vec3 uSelectedCellPos = vec3(-9999.0); // Position of selected cell, invalid position by default
-uniform float uSelectedCellRadius = 0.0;
-uniform float uTime = 0.0; // For animation effects
-uniform vec3 uFogColor = vec3(0.1, 0.15, 0.3); // Atmospheric/fog color for distant cells
+#include "gpu_constants.glsl"
 
 void main() {
     // Check if this is the selected cell
@@ -0,0 +1,70 @@
+#version 430 core
+
+// The impostor quad lies in front of the sphere, so the ray-cast depth is never closer
+// than the rasterized depth. This lets the driver keep early depth rejection.
+layout(depth_greater) out float gl_FragDepth;
+
+in vec3 vWorldPos;
+flat in vec3 vInstanceCenter;
+flat in float vRadius;
+flat in vec3 vBaseColor;
+flat in float vFadeFactor;
+
+out vec4 fragColor;
+
+#include "gpu_constants.glsl"
+
+void main() {
+    // Ray from the camera through this fragment of the quad
+    vec3 rayDir = normalize(vWorldPos - uCameraPos);
+    vec3 oc = uCameraPos - vInstanceCenter;
+
+    // Ray-sphere intersection (rayDir is normalized, so a = 1)
+    float b = dot(oc, rayDir);
+    float c = dot(oc, oc) - vRadius * vRadius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0) {
+        discard; // Outside the sphere silhouette
+    }
+    float t = -b - sqrt(discriminant);
+
+    vec3 hitPos = uCameraPos + rayDir * t;
+    vec3 normal = normalize(hitPos - vInstanceCenter);
+
+    // Write the depth of the actual sphere surface so impostors intersect meshes correctly
+    vec4 clipPos = uProjection * uView * vec4(hitPos, 1.0);
+    float ndcDepth = clipPos.z / clipPos.w;
+    gl_FragDepth = ((gl_DepthRange.diff * ndcDepth) + gl_DepthRange.near + gl_DepthRange.far) * 0.5;
+
+    // Check if this is the selected cell
+    float distanceToSelected = length(vInstanceCenter - uSelectedCellPos);
+    bool isSelected = distanceToSelected < 0.1 && uSelectedCellRadius > 0.0;
+
+    // Same lighting model as sphere_distance_fade.frag so LOD transitions are seamless
+    vec3 lightDir = normalize(uLightDir);
+    vec3 viewDir = normalize(uCameraPos - hitPos);
+
+    float lambertian = max(0.1, dot(normal, lightDir));
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float specular = pow(max(0.0, dot(viewDir, reflectDir)), 32.0) * 0.3;
+
+    vec3 baseColor = vBaseColor;
+
+    // Highlight selected cell
+    if (isSelected) {
+        float pulse = 0.5 + 0.5 * sin(uTime * 6.0); // Pulsing effect
+        baseColor = mix(baseColor, vec3(1.0, 1.0, 0.0), 0.3 + 0.2 * pulse);
+        specular *= 2.0;
+    }
+
+    vec3 finalColor = baseColor * lambertian + vec3(1.0) * specular;
+
+    // Apply distance-based fade factor by darkening the color
+    finalColor *= vFadeFactor;
+
+    // Add atmospheric scattering for very distant cells (blend with fog color)
+    float atmosphericScatter = 1.0 - vFadeFactor;
+    finalColor = mix(finalColor, uFogColor, atmosphericScatter * 0.5);
+
+    fragColor = vec4(finalColor, 1.0);
+}
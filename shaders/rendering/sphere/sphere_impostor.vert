@@ -0,0 +1,56 @@
+#version 430 core
+
+// Ray-cast sphere impostor: one camera-facing quad per cell, no mesh attributes.
+// Instance data is pulled from the unified culling output by gl_InstanceID and
+// the quad corners are generated from gl_VertexID (drawn as a 4 vertex strip).
+
+#include "instance_data.glsl"
+
+layout(std430, binding = 0) readonly buffer ImpostorInstanceBuffer {
+    InstanceData instances[];
+};
+
+#include "gpu_constants.glsl"
+
+out vec3 vWorldPos;
+flat out vec3 vInstanceCenter;
+flat out float vRadius;
+flat out vec3 vBaseColor;
+flat out float vFadeFactor;
+
+void main() {
+    InstanceData instance = instances[gl_InstanceID];
+    vec3 center = instance.positionAndRadius.xyz;
+    float radius = instance.positionAndRadius.w;
+
+    vec3 toCenter = center - uCameraPos;
+    float dist = length(toCenter);
+    vec3 forward = toCenter / max(dist, 1e-5);
+
+    // Build a basis facing the camera (avoid a degenerate cross product when looking straight up/down)
+    vec3 upHint = abs(forward.y) > 0.99 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(forward, upHint));
+    vec3 up = cross(right, forward);
+
+    // Place the quad on the sphere's near tangent plane and size it to the silhouette cone,
+    // so every covered fragment lies in front of the sphere surface (see depth_greater in the frag shader)
+    float planeDist = max(dist - radius, 1e-3);
+    float halfSize = planeDist * radius / sqrt(max(dist * dist - radius * radius, 1e-6));
+
+    // Strip order: (-1,-1), (1,-1), (-1,1), (1,1)
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+    vec3 worldPos = uCameraPos + forward * planeDist + (right * corner.x + up * corner.y) * halfSize;
+
+    // Camera inside the sphere: collapse the quad, the mesh LODs handle close cells anyway
+    if (dist <= radius) {
+        worldPos = center;
+    }
+
+    vWorldPos = worldPos;
+    vInstanceCenter = center;
+    vRadius = radius;
+    vBaseColor = instance.color.rgb;
+    vFadeFactor = instance.fadeFactor.x;
+
+    gl_Position = uProjection * uView * vec4(worldPos, 1.0);
+}
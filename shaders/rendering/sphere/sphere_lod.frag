@@ -8,10 +8,7 @@ in vec3 vInstanceCenter;
 in vec3 vBaseColor;
 
 
-uniform vec3 uLightDir;
-uniform vec3 uSelectedCellPos;
-uniform float uSelectedCellRadius;
-uniform float uTime;
+#include "gpu_constants.glsl"
 
 out vec4 FragColor;
 
@@ -17,12 +17,22 @@ namespace config
 	constexpr const char* APPLICATION_NAME{"Biospheres"};
 	constexpr bool PLAY_STARTUP_JINGLE{false};
 	constexpr bool VSYNC{ true };
+	constexpr bool SHADER_HOT_RELOAD{ true };  // Recompile shaders when their files (or includes) change on disk
 
 	// ========== Cell Simulation Configuration ==========
-	constexpr int MAX_CELLS{100000};
+	constexpr int MAX_CELLS{100000};                              // Default cell limit of the main scene
+	constexpr int MAX_CELL_LIMIT{2000000};                        // Highest cell limit the main scene can be set to (buffers only grow that far if GPU memory allows)
+	constexpr int INITIAL_CELL_CAPACITY{1024};                    // Cells the per-cell buffers are allocated for before the population grows
+	constexpr int CELL_CAPACITY_HEADROOM{4};                      // Per-cell buffers grow once they hold less than this many times the cell count
+	constexpr int CELL_MANAGER_GPU_BUDGET_MB{4096};               // Most GPU memory one CellManager's buffer arena may hold (0 = unlimited)
+	constexpr int CELL_UPLOAD_RING_INITIAL_CELLS{1024};           // Cells the mapped upload ring holds before a large spawn grows it
+	constexpr int READBACK_POOL_BUFFERS_PER_CLASS{4};             // Idle readback staging buffers kept per size class, extra ones are freed
+	constexpr int COUNT_SNAPSHOT_SLOTS{4};                        // Cell counter copies in flight at once; the CPU count lags by at most this many ticks
 	constexpr int DEFAULT_CELL_COUNT{100000};
 	constexpr int MAX_ADHESIONS{ MAX_CELLS * 12 };
+	constexpr int ADHESIONS_PER_CELL{1};                          // Adhesion connection slots per cell slot, the connection buffer grows with the cell buffers
 	constexpr float DEFAULT_SPAWN_RADIUS{50.0f};
+	constexpr int INITIAL_MODE_CAPACITY{64};                      // Mode slots allocated up front; the mode buffer doubles when genomes need more
 
 	// ========== Spatial Partitioning Configuration ==========
 	constexpr float WORLD_SIZE{100.0f};                          // Size of the simulation world (cube from -50 to +50)
@@ -31,6 +41,27 @@ namespace config
 	constexpr int MAX_CELLS_PER_GRID{32};                         // Reduced from 64 to 32: better memory access patterns
 	constexpr int TOTAL_GRID_CELLS{GRID_RESOLUTION * GRID_RESOLUTION * GRID_RESOLUTION};
 
+	// ========== Time Scrubber Configuration ==========
+	constexpr int KEYFRAME_FULL_INTERVAL{10};                  // Every Nth scrubber keyframe is stored in full, the rest as deltas (bounds restore cost)
+	constexpr double KEYFRAME_BUILD_BUDGET_MS{4.0};             // Time per frame spent simulating in the background keyframe build
+	constexpr int KEYFRAME_ARENA_BYTES{16 * 1024 * 1024};       // VRAM for GPU-resident keyframes; keyframes that don't fit are compressed on the CPU
+	constexpr double GENOME_RESIM_DEBOUNCE_MS{150.0};           // Genome edits closer together than this are resimulated once
+	constexpr int KEYFRAME_REPLAY_STEPS{200};                   // Keyframes are placed so replaying to any time costs at most this many physics steps of a full (cell limit) population
+
+	// ========== Checkpoint Configuration ==========
+	constexpr int CHECKPOINT_CHUNK_BYTES{4 * 1024 * 1024};     // Size of the staging buffer cells and adhesions are streamed to disk through
+
+	// ========== Trajectory Recording Configuration ==========
+	constexpr int TRAJECTORY_RECORD_INTERVAL{10};               // Simulation ticks between recorded trajectory frames
+	constexpr int TRAJECTORY_KEYFRAME_INTERVAL{100};            // Recorded frames between self-contained key frames (seek granularity for playback)
+	constexpr int TRAJECTORY_RING_SLOTS{3};                     // Frames that can be in flight between the GPU and the writer thread
+	constexpr float TRAJECTORY_POSITION_STEP{1.0f / 4096.0f};   // Quantisation steps of the recorded fields
+	constexpr float TRAJECTORY_ORIENTATION_STEP{1.0f / 32768.0f};
+	constexpr float TRAJECTORY_AGE_STEP{1.0f / 1024.0f};
+
+	// ========== Ensemble Configuration ==========
+	constexpr int ENSEMBLE_MAX_SIMULATIONS{256};                // Most parameter sweep variants run side by side in the main simulation
+
 	// ========== Rendering Configuration ==========
 	// Distance-based culling and fading parameters
 	constexpr float defaultMaxRenderDistance{170.0f};         // Maximum distance to render cells
@@ -46,10 +77,14 @@ namespace config
 
 	// LOD (Level of Detail) configuration
 	constexpr bool defaultUseLodSystem{true};                 // Enable/disable LOD system by default
-	constexpr float defaultLodDistance0{40.0f};               // Distance threshold for LOD level 0 (highest quality)
-	constexpr float defaultLodDistance1{80.0f};               // Distance threshold for LOD level 1
-	constexpr float defaultLodDistance2{120.0f};              // Distance threshold for LOD level 2
-	constexpr float defaultLodDistance3{160.0f};              // Distance threshold for LOD level 3 (lowest quality)
+	constexpr float defaultLodDistance0{30.0f};               // Distance threshold for LOD level 0 (highest quality)
+	constexpr float defaultLodDistance1{60.0f};               // Distance threshold for LOD level 1
+	constexpr float defaultLodDistance2{90.0f};               // Distance threshold for LOD level 2
+	constexpr float defaultLodDistance3{120.0f};              // Distance threshold for LOD level 3 (lowest quality mesh)
+	                                                          // Cells beyond LOD 3 are drawn as ray-cast sphere impostors (LOD 4)
+
+	// Debug overlay configuration
+	constexpr int ringGizmoMaxLod{1};                         // Ring gizmos are drawn for visible cells up to this LOD level (plus the selected cell)
 
 	// Distance culling configuration
 	constexpr bool defaultUseDistanceCulling{true};           // Enable/disable distance-based culling by default
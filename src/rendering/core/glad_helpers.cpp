@@ -14,4 +14,36 @@ void initGLAD(GLFWwindow* window)
 	int display_w, display_h;
 	glfwGetFramebufferSize(window, &display_w, &display_h);
 	glViewport(0, 0, display_w, display_h);
-}
\ No newline at end of file
+}
+// Tokens from the extension specs, glad is generated without either extension
+#define GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX 0x9048
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#define GL_VBO_FREE_MEMORY_ATI 0x87FB
+
+bool queryGPUMemoryInfo(GPUMemoryInfo& info)
+{
+	static const bool hasNVX = glfwExtensionSupported("GL_NVX_gpu_memory_info");
+	static const bool hasATI = glfwExtensionSupported("GL_ATI_meminfo");
+
+	// Both extensions report kilobytes
+	if (hasNVX)
+	{
+		GLint totalKB = 0, availableKB = 0;
+		glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &totalKB);
+		glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKB);
+		info.totalBytes = static_cast<size_t>(totalKB) * 1024;
+		info.availableBytes = static_cast<size_t>(availableKB) * 1024;
+		info.source = "NVX_gpu_memory_info";
+		return true;
+	}
+	if (hasATI)
+	{
+		GLint freeKB[4]{}; // total free, largest free block, total auxiliary free, largest auxiliary block
+		glGetIntegerv(GL_VBO_FREE_MEMORY_ATI, freeKB);
+		info.totalBytes = 0;
+		info.availableBytes = static_cast<size_t>(freeKB[0]) * 1024;
+		info.source = "ATI_meminfo";
+		return true;
+	}
+	return false;
+}
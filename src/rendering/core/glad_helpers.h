@@ -2,6 +2,18 @@
 #include<glad/glad.h>
 #include<GLFW/glfw3.h>
 #include <iostream>
+#include <cstddef>
 
 // I'm pretty sure that this is the only glad thing we will ever need to use
-void initGLAD(GLFWwindow* window);
\ No newline at end of file
+void initGLAD(GLFWwindow* window);
+// Video memory as reported by the driver (GL_NVX_gpu_memory_info on NVIDIA, GL_ATI_meminfo on AMD).
+// ATI_meminfo only reports what is free, so totalBytes stays 0 there.
+struct GPUMemoryInfo
+{
+	size_t totalBytes = 0;
+	size_t availableBytes = 0;
+	const char* source = "";
+};
+
+// Returns false if the driver exposes neither extension
+bool queryGPUMemoryInfo(GPUMemoryInfo& info);
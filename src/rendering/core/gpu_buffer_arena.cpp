@@ -0,0 +1,150 @@
+#include "gpu_buffer_arena.h"
+
+#include <algorithm>
+#include <iostream>
+
+const char* getGPUSubsystemName(GPUSubsystem subsystem)
+{
+	switch (subsystem)
+	{
+	case GPUSubsystem::Cells:     return "Cells";
+	case GPUSubsystem::Modes:     return "Modes";
+	case GPUSubsystem::Grid:      return "Spatial Grid";
+	case GPUSubsystem::Instances: return "Instances";
+	case GPUSubsystem::Adhesion:  return "Adhesion";
+	case GPUSubsystem::Gizmo:     return "Gizmos";
+	case GPUSubsystem::Constants: return "Constants";
+	case GPUSubsystem::Readback:  return "Readback";
+	case GPUSubsystem::Upload:    return "Upload";
+	case GPUSubsystem::Keyframes: return "Keyframes";
+	case GPUSubsystem::Trajectory: return "Trajectory";
+	default:                      return "Unknown";
+	}
+}
+
+GLsizeiptr GPUBufferArena::getRangeAlignment()
+{
+	// Ranges are bound with glBindBufferRange, so they have to honour the SSBO offset alignment
+	static GLsizeiptr alignment = [] {
+		GLint value = 0;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &value);
+		return static_cast<GLsizeiptr>(std::max(value, 256));
+	}();
+	return alignment;
+}
+
+GLsizeiptr GPUBufferArena::alignRange(GLsizeiptr offset)
+{
+	GLsizeiptr alignment = getRangeAlignment();
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool GPUBufferArena::fitsBudget(size_t bytes, size_t releasedBytes) const
+{
+	if (budgetBytes == 0)
+		return true;
+	size_t remaining = totalBytes - std::min(totalBytes, releasedBytes);
+	return remaining + bytes <= budgetBytes;
+}
+
+GLuint GPUBufferArena::createBuffer(GPUSubsystem subsystem, GLsizeiptr size, GLbitfield flags, const void* data)
+{
+	size = std::max<GLsizeiptr>(size, 1);
+	if (!fitsBudget(static_cast<size_t>(size)))
+	{
+		std::cout << "Warning: " << getGPUSubsystemName(subsystem) << " buffer of " << size / 1024
+			<< " KB would exceed the GPU memory budget of " << budgetBytes / (1024 * 1024) << " MB\n";
+		return 0;
+	}
+
+	// A failed glNamedBufferStorage leaves the buffer without storage, so its size tells whether the
+	// allocation worked without touching the GL error queue (checkGLError still sees every error)
+	GLuint buffer = 0;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, size, data, flags);
+	GLint64 allocatedSize = 0;
+	glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &allocatedSize);
+	if (allocatedSize != size)
+	{
+		glDeleteBuffers(1, &buffer);
+		std::cout << "Warning: out of GPU memory allocating " << size / 1024 << " KB for "
+			<< getGPUSubsystemName(subsystem) << "\n";
+		return 0;
+	}
+
+	allocations[buffer] = { subsystem, static_cast<size_t>(size) };
+	subsystemBytes[static_cast<int>(subsystem)] += static_cast<size_t>(size);
+	subsystemBuffers[static_cast<int>(subsystem)]++;
+	totalBytes += static_cast<size_t>(size);
+	return buffer;
+}
+
+std::vector<GPUBufferRange> GPUBufferArena::createBlock(GPUSubsystem subsystem, const std::vector<GLsizeiptr>& sizes, GLbitfield flags)
+{
+	std::vector<GPUBufferRange> ranges(sizes.size());
+	GLsizeiptr offset = 0;
+	for (size_t i = 0; i < sizes.size(); i++)
+	{
+		offset = alignRange(offset);
+		ranges[i].offset = offset;
+		ranges[i].size = sizes[i];
+		offset += sizes[i];
+	}
+
+	GLuint buffer = createBuffer(subsystem, offset, flags);
+	if (buffer == 0)
+		return {};
+	for (GPUBufferRange& range : ranges)
+	{
+		range.buffer = buffer;
+	}
+	return ranges;
+}
+
+void GPUBufferArena::destroyBuffer(GLuint& buffer)
+{
+	if (buffer == 0)
+		return;
+
+	auto it = allocations.find(buffer);
+	if (it != allocations.end())
+	{
+		subsystemBytes[static_cast<int>(it->second.subsystem)] -= it->second.size;
+		subsystemBuffers[static_cast<int>(it->second.subsystem)]--;
+		totalBytes -= it->second.size;
+		allocations.erase(it);
+	}
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+void GPUBufferArena::destroyBlock(std::vector<GPUBufferRange*> ranges)
+{
+	if (!ranges.empty() && ranges.front()->buffer != 0)
+	{
+		GLuint buffer = ranges.front()->buffer;
+		destroyBuffer(buffer);
+	}
+	for (GPUBufferRange* range : ranges)
+	{
+		*range = GPUBufferRange{};
+	}
+}
+
+void GPUBufferArena::releaseAll()
+{
+	for (auto& [buffer, allocation] : allocations)
+	{
+		glDeleteBuffers(1, &buffer);
+	}
+	allocations.clear();
+	std::fill(std::begin(subsystemBytes), std::end(subsystemBytes), size_t{ 0 });
+	std::fill(std::begin(subsystemBuffers), std::end(subsystemBuffers), 0);
+	totalBytes = 0;
+}
+
+size_t GPUBufferArena::getBufferBytes(GLuint buffer) const
+{
+	auto it = allocations.find(buffer);
+	return it != allocations.end() ? it->second.size : 0;
+}
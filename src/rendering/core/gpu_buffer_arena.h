@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// Subsystems GPU storage is accounted to (see GPUBufferArena::getSubsystemBytes)
+enum class GPUSubsystem
+{
+	Cells,     // Cell buffers, counters, compaction scratch
+	Modes,     // Mode table and reached-mode bits
+	Grid,      // Spatial grid
+	Instances, // Instance, LOD and culling outputs
+	Adhesion,  // Adhesion connections
+	Gizmo,     // Debug geometry
+	Constants, // Uniform blocks
+	Readback,  // CPU-visible staging buffers
+	Upload,    // CPU-written upload rings
+	Keyframes, // GPU-resident scrubbing keyframes
+	Trajectory, // Trajectory recording ring
+	Count
+};
+
+const char* getGPUSubsystemName(GPUSubsystem subsystem);
+
+// A byte range inside an arena buffer
+struct GPUBufferRange
+{
+	GLuint buffer = 0;
+	GLintptr offset = 0;
+	GLsizeiptr size = 0;
+
+	bool isValid() const { return buffer != 0; }
+	void bindStorage(GLuint binding) const { glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, buffer, offset, size); }
+	void clear() const { glClearNamedBufferSubData(buffer, GL_R32UI, offset, size, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr); }
+};
+
+// Owns every GPU buffer of a CellManager.
+// All storage is immutable (glNamedBufferStorage with explicit flags, no usage hints), tagged with the
+// subsystem it belongs to and checked against a budget before it is allocated, so there is one place
+// that knows how much VRAM a simulation holds and one place that can refuse to grow it.
+// Buffers that are always used together (e.g. the spatial grid) are packed into one buffer as aligned
+// ranges with createBlock; everything else gets its own buffer, because most of it is resized with
+// the cell capacity and bound or copied whole by many passes.
+class GPUBufferArena
+{
+public:
+	GPUBufferArena() = default;
+	~GPUBufferArena() { releaseAll(); }
+	GPUBufferArena(const GPUBufferArena&) = delete;
+	GPUBufferArena& operator=(const GPUBufferArena&) = delete;
+
+	// Creates an immutable buffer; returns 0 (and prints why) if it would exceed the budget or the GPU is out of memory
+	GLuint createBuffer(GPUSubsystem subsystem, GLsizeiptr size, GLbitfield flags, const void* data = nullptr);
+	// One immutable buffer holding every size as a range aligned for SSBO binding; empty on failure
+	std::vector<GPUBufferRange> createBlock(GPUSubsystem subsystem, const std::vector<GLsizeiptr>& sizes, GLbitfield flags);
+	// Deletes a buffer created by this arena and sets the handle to 0 (no-op for 0)
+	void destroyBuffer(GLuint& buffer);
+	void destroyBlock(std::vector<GPUBufferRange*> ranges);
+	void releaseAll();
+
+	// 0 = unlimited
+	void setBudget(size_t bytes) { budgetBytes = bytes; }
+	size_t getBudget() const { return budgetBytes; }
+	// True if `bytes` more (after `releasedBytes` are freed) fit in the budget
+	bool fitsBudget(size_t bytes, size_t releasedBytes = 0) const;
+
+	size_t getTotalBytes() const { return totalBytes; }
+	size_t getSubsystemBytes(GPUSubsystem subsystem) const { return subsystemBytes[static_cast<int>(subsystem)]; }
+	int getSubsystemBufferCount(GPUSubsystem subsystem) const { return subsystemBuffers[static_cast<int>(subsystem)]; }
+	size_t getBufferBytes(GLuint buffer) const;
+
+	// Offset alignment every range has to honour to be bound as an SSBO
+	static GLsizeiptr getRangeAlignment();
+
+private:
+	struct Allocation
+	{
+		GPUSubsystem subsystem;
+		size_t size;
+	};
+
+	static GLsizeiptr alignRange(GLsizeiptr offset);
+
+	std::unordered_map<GLuint, Allocation> allocations;
+	size_t subsystemBytes[static_cast<int>(GPUSubsystem::Count)]{};
+	int subsystemBuffers[static_cast<int>(GPUSubsystem::Count)]{};
+	size_t totalBytes = 0;
+	size_t budgetBytes = 0;
+};
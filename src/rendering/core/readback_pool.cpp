@@ -0,0 +1,138 @@
+#include "readback_pool.h"
+#include "../../core/config.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	constexpr GLbitfield READBACK_FLAGS = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+int ReadbackPool::getSizeClass(GLsizeiptr size)
+{
+	int sizeClass = MIN_SIZE_CLASS;
+	while ((GLsizeiptr{ 1 } << sizeClass) < size)
+	{
+		sizeClass++;
+	}
+	sizeClass -= MIN_SIZE_CLASS;
+	return sizeClass < SIZE_CLASSES ? sizeClass : -1;
+}
+
+ReadbackBuffer ReadbackPool::acquire(GLsizeiptr size)
+{
+	int sizeClass = getSizeClass(size);
+	if (sizeClass >= 0)
+	{
+		std::vector<IdleBuffer>& idle = idleBuffers[sizeClass];
+		for (size_t i = 0; i < idle.size(); i++)
+		{
+			if (idle[i].fence)
+			{
+				GLenum result = glClientWaitSync(idle[i].fence, 0, 0);
+				if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+					continue; // A copy is still writing into it
+				glDeleteSync(idle[i].fence);
+			}
+			ReadbackBuffer buffer = idle[i].buffer;
+			idle.erase(idle.begin() + i);
+			return buffer;
+		}
+	}
+
+	ReadbackBuffer buffer;
+	buffer.size = sizeClass >= 0 ? GLsizeiptr{ 1 } << (sizeClass + MIN_SIZE_CLASS) : size;
+	buffer.buffer = arena.createBuffer(GPUSubsystem::Readback, buffer.size, READBACK_FLAGS | GL_CLIENT_STORAGE_BIT);
+	if (buffer.buffer == 0)
+		return {};
+	buffer.mapped = static_cast<const uint8_t*>(glMapNamedBufferRange(buffer.buffer, 0, buffer.size, READBACK_FLAGS));
+	if (!buffer.mapped)
+	{
+		std::cout << "Error: could not map a readback buffer\n";
+		arena.destroyBuffer(buffer.buffer);
+		return {};
+	}
+	allocationCount++;
+	return buffer;
+}
+
+void ReadbackPool::recycle(const ReadbackBuffer& buffer, GLsync fence)
+{
+	if (!buffer.isValid())
+		return;
+
+	IdleBuffer idle{ buffer, fence };
+	int sizeClass = getSizeClass(buffer.size);
+	if (sizeClass < 0 || static_cast<int>(idleBuffers[sizeClass].size()) >= config::READBACK_POOL_BUFFERS_PER_CLASS)
+	{
+		destroy(idle); // GL defers deleting it until a pending copy is done
+		return;
+	}
+	idleBuffers[sizeClass].push_back(idle);
+}
+
+bool ReadbackPool::read(GLuint source, GLintptr offset, GLsizeiptr size, void* destination)
+{
+	if (size <= 0)
+		return true;
+
+	ReadbackBuffer buffer = acquire(size);
+	if (!buffer.isValid())
+		return false;
+
+	glCopyNamedBufferSubData(source, buffer.buffer, offset, 0, size);
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(fence);
+
+	std::memcpy(destination, buffer.mapped, static_cast<size_t>(size));
+	recycle(buffer);
+	return true;
+}
+
+void ReadbackPool::releaseAll()
+{
+	for (std::vector<IdleBuffer>& idle : idleBuffers)
+	{
+		for (IdleBuffer& entry : idle)
+		{
+			destroy(entry);
+		}
+		idle.clear();
+	}
+}
+
+void ReadbackPool::destroy(IdleBuffer& idle)
+{
+	if (idle.fence)
+	{
+		glDeleteSync(idle.fence);
+		idle.fence = nullptr;
+	}
+	glUnmapNamedBuffer(idle.buffer.buffer);
+	arena.destroyBuffer(idle.buffer.buffer);
+}
+
+int ReadbackPool::getIdleBufferCount() const
+{
+	int count = 0;
+	for (const std::vector<IdleBuffer>& idle : idleBuffers)
+	{
+		count += static_cast<int>(idle.size());
+	}
+	return count;
+}
+
+size_t ReadbackPool::getIdleBytes() const
+{
+	size_t bytes = 0;
+	for (const std::vector<IdleBuffer>& idle : idleBuffers)
+	{
+		for (const IdleBuffer& entry : idle)
+		{
+			bytes += static_cast<size_t>(entry.buffer.size);
+		}
+	}
+	return bytes;
+}
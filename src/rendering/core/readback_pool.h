@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gpu_buffer_arena.h"
+
+// A persistently mapped buffer the GPU copies into and the CPU reads from
+struct ReadbackBuffer
+{
+	GLuint buffer = 0;
+	const uint8_t* mapped = nullptr;
+	GLsizeiptr size = 0; // Allocated size, rounded up to the size class
+
+	bool isValid() const { return buffer != 0; }
+};
+
+// Recycles readback staging buffers, so reading the GPU back doesn't create and delete GL objects every time.
+// Idle buffers are kept per power-of-two size class. A buffer can be handed back together with the fence
+// of a copy that may still be writing into it; it is only given out again once that fence has signalled.
+class ReadbackPool
+{
+public:
+	explicit ReadbackPool(GPUBufferArena& arena) : arena(arena) {}
+
+	// A mapped buffer of at least `size` bytes, invalid if the budget or the driver refuses
+	ReadbackBuffer acquire(GLsizeiptr size);
+	// Hands a buffer back; the pool takes ownership of `fence`
+	void recycle(const ReadbackBuffer& buffer, GLsync fence = nullptr);
+	// Copies `size` bytes of `source` into `destination` through a pooled buffer and waits for them.
+	// The caller is responsible for the barrier that makes earlier shader writes visible to the copy.
+	bool read(GLuint source, GLintptr offset, GLsizeiptr size, void* destination);
+	void releaseAll();
+
+	int getIdleBufferCount() const;
+	size_t getIdleBytes() const;
+	int getAllocationCount() const { return allocationCount; } // Buffers created so far, stays flat once the pool is warm
+
+private:
+	struct IdleBuffer
+	{
+		ReadbackBuffer buffer;
+		GLsync fence = nullptr;
+	};
+
+	static constexpr int MIN_SIZE_CLASS = 12; // 4 KB
+	static constexpr int SIZE_CLASSES = 20;   // Up to 2 GB, larger buffers aren't pooled
+	static int getSizeClass(GLsizeiptr size);
+	void destroy(IdleBuffer& idle);
+
+	GPUBufferArena& arena;
+	std::vector<IdleBuffer> idleBuffers[SIZE_CLASSES];
+	int allocationCount = 0;
+};
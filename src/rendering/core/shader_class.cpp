@@ -1,5 +1,10 @@
 #include "shader_class.h"
+#include "shader_registry.h"
 #include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
 #include <cerrno>
 #include <glm/vec2.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -26,110 +31,120 @@ std::string get_file_contents(const char* filename)
 	throw(errno);
 }
 
-// Constructor that build the Shader Program from a vertex and fragment shader
-Shader::Shader(const char* vertexFile, const char* fragmentFile)
+namespace
 {
-	int success;
-	char infoLog[512];
-
-	// Read vertexFile and fragmentFile and store the strings
-	std::string vertexCode = get_file_contents(vertexFile);
-	std::string fragmentCode = get_file_contents(fragmentFile);
-
-	// Convert the shader source strings into character arrays
-	const char* vertexSource = vertexCode.c_str();
-	const char* fragmentSource = fragmentCode.c_str();
-
-	// Create Vertex Shader Object and get its reference
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	// Attach Vertex Shader source to the Vertex Shader Object
-	glShaderSource(vertexShader, 1, &vertexSource, NULL);
-	// Compile the Vertex Shader into machine code
-	glCompileShader(vertexShader);
-	// Print compile errors if any
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		//Make sure there are no typos in the name!
+	const char* SHADER_INCLUDE_DIRECTORY = "shaders/include";
 
+	std::unordered_map<std::string, std::string>& virtualIncludes()
+	{
+		static std::unordered_map<std::string, std::string> includes;
+		return includes;
 	}
 
-	// Create Fragment Shader Object and get its reference
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	// Attach Fragment Shader source to the Fragment Shader Object
-	glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-	// Compile the Fragment Shader into machine code
-	glCompileShader(fragmentShader);
-	// Print compile errors if any
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+	// Parses `#include "name"` and returns the name, or an empty string if the line is not an include
+	std::string parseInclude(const std::string& line)
 	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << "\n";
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line.compare(pos, 8, "#include") != 0)
+		{
+			return {};
+		}
+		size_t open = line.find('"', pos + 8);
+		size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+		if (close == std::string::npos)
+		{
+			return {};
+		}
+		return line.substr(open + 1, close - open - 1);
 	}
 
-	// Create Shader Program Object and get its reference
-	ID = glCreateProgram();
-	// Attach the Vertex and Fragment Shaders to the Shader Program
-	glAttachShader(ID, vertexShader);
-	glAttachShader(ID, fragmentShader);
-	// Wrap-up/Link all the shaders together into the Shader Program
-	glLinkProgram(ID);
-	// Print linking errors if any
-	glGetProgramiv(ID, GL_LINK_STATUS, &success);
-	if (!success)
+	void expandIncludes(const std::string& path, const std::string& source, int sourceNumber,
+		std::unordered_set<std::string>& included, std::vector<std::string>* dependencies, std::string& output, int& nextSourceNumber)
 	{
-		glGetProgramInfoLog(ID, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << "\n";
+		std::istringstream stream(source);
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(stream, line))
+		{
+			lineNumber++;
+			std::string name = parseInclude(line);
+			if (name.empty())
+			{
+				output += line;
+				output += '\n';
+				continue;
+			}
+
+			std::string includeSource;
+			std::string includePath;
+			auto generated = virtualIncludes().find(name);
+			if (generated != virtualIncludes().end())
+			{
+				includePath = name;
+				includeSource = generated->second;
+			}
+			else
+			{
+				// Relative to the including file first, then the shared include directory
+				std::filesystem::path local = std::filesystem::path(path).parent_path() / name;
+				std::filesystem::path shared = std::filesystem::path(SHADER_INCLUDE_DIRECTORY) / name;
+				includePath = (std::filesystem::exists(local) ? local : shared).generic_string();
+			}
+
+			if (!included.insert(includePath).second)
+			{
+				output += "\n"; // Already included, keep the line count intact
+				continue;
+			}
+
+			if (generated == virtualIncludes().end())
+			{
+				includeSource = get_file_contents(includePath.c_str());
+				if (dependencies) dependencies->push_back(includePath);
+			}
+
+			// #line keeps compiler errors pointing at the right file (source string number) and line
+			int includeNumber = nextSourceNumber++;
+			output += "#line 1 " + std::to_string(includeNumber) + "\n";
+			expandIncludes(includePath, includeSource, includeNumber, included, dependencies, output, nextSourceNumber);
+			output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+		}
 	}
+}
+
+std::string get_shader_source(const char* filename, std::vector<std::string>* dependencies)
+{
+	std::string source = get_file_contents(filename);
+	if (dependencies) dependencies->push_back(filename);
+
+	std::unordered_set<std::string> included;
+	std::string output;
+	int nextSourceNumber = 1;
+	expandIncludes(filename, source, 0, included, dependencies, output, nextSourceNumber);
+	return output;
+}
 
-	// destroy the now useless Vertex and Fragment Shader objects
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
+void register_shader_include(const std::string& name, const std::string& contents)
+{
+	virtualIncludes()[name] = contents;
+}
 
+// Constructor that build the Shader Program from a vertex and fragment shader
+// Programs are shared through the ShaderRegistry, so identical shaders are only compiled once
+Shader::Shader(const char* vertexFile, const char* fragmentFile)
+{
+	ID = ShaderRegistry::instance().acquire({
+		{ GL_VERTEX_SHADER, vertexFile },
+		{ GL_FRAGMENT_SHADER, fragmentFile }
+	}, this);
 }
 
 // Constructor for compute shader
 Shader::Shader(const char* computeFile)
 {
-	int success;
-	char infoLog[512];
-
-	// Read computeFile and store the string
-	std::string computeCode = get_file_contents(computeFile);
-	const char* computeSource = computeCode.c_str();
-
-	// Create Compute Shader Object and get its reference
-	GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
-	// Attach Compute Shader source to the Compute Shader Object
-	glShaderSource(computeShader, 1, &computeSource, NULL);
-	// Compile the Compute Shader into machine code
-	glCompileShader(computeShader);
-	// Print compile errors if any
-	glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::COMPUTE::COMPILATION_FAILED\n" << infoLog << "\n";
-	}
-
-	// Create Shader Program Object and get its reference
-	ID = glCreateProgram();
-	// Attach the Compute Shader to the Shader Program
-	glAttachShader(ID, computeShader);
-	// Link the shader program
-	glLinkProgram(ID);
-	// Print linking errors if any
-	glGetProgramiv(ID, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(ID, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::COMPUTE_PROGRAM::LINKING_FAILED\n" << infoLog << "\n";
-	}
-
-	// destroy the now useless Compute Shader object
-	glDeleteShader(computeShader);
+	ID = ShaderRegistry::instance().acquire({
+		{ GL_COMPUTE_SHADER, computeFile }
+	}, this);
 }
 
 // Activates the Shader Program
@@ -138,10 +153,18 @@ void Shader::use()
 	glUseProgram(ID);
 }
 
-// Deletes the Shader Program
+// Releases the Shader Program (deleted once no other Shader shares it)
 void Shader::destroy()
 {
-	if (ID) glDeleteProgram(ID);
+	if (ID) ShaderRegistry::instance().release(ID, this);
+	ID = 0;
+}
+
+// Called by the ShaderRegistry when a hot reload replaced the program
+void Shader::onProgramReloaded(GLuint newID)
+{
+	ID = newID;
+	uniformLocations.clear(); // Locations may differ in the new program
 }
 
 // Dispatch compute shader
@@ -150,52 +173,75 @@ void Shader::dispatch(GLuint num_groups_x, GLuint num_groups_y, GLuint num_group
 	glDispatchCompute(num_groups_x, num_groups_y, num_groups_z);
 }
 
+// Dispatch compute shader with the group counts stored in a buffer by an earlier pass
+void Shader::dispatchIndirect(GLuint buffer, GLintptr offset)
+{
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+	glDispatchComputeIndirect(offset);
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
+
+// Uniform locations are cached per shader, keyed by the full name
+GLint Shader::getUniformLocation(std::string_view name) const
+{
+	auto cached = uniformLocations.find(name);
+	if (cached != uniformLocations.end())
+	{
+		return cached->second;
+	}
+
+	std::string key(name);
+	GLint location = glGetUniformLocation(ID, key.c_str());
+	uniformLocations.emplace(std::move(key), location);
+	return location;
+}
+
 // utility uniform functions
 
-void Shader::setInt(const std::string& name, int value) const
+void Shader::setInt(std::string_view name, int value) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform1i(location, value);
 }
 
-void Shader::setFloat(const std::string& name, float value) const
+void Shader::setFloat(std::string_view name, float value) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform1f(location, value);
 }
 
-void Shader::setVec2(const std::string& name, float x, float y) const
+void Shader::setVec2(std::string_view name, float x, float y) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform2f(location, x, y);
 }
 
-void Shader::setVec2(const std::string& name, glm::vec2 vector) const
+void Shader::setVec2(std::string_view name, glm::vec2 vector) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform2f(location, vector.x, vector.y);
 }
 
-void Shader::setVec3(const std::string& name, float x, float y, float z) const
+void Shader::setVec3(std::string_view name, float x, float y, float z) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform3f(location, x, y ,z);
 }
 
-void Shader::setVec3(const std::string& name, glm::vec3 vector) const
+void Shader::setVec3(std::string_view name, glm::vec3 vector) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform3f(location, vector.x, vector.y, vector.z);
 }
 
-void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
+void Shader::setVec4(std::string_view name, float x, float y, float z, float w) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniform4f(location, x, y, z, w);
 }
 
-void Shader::setMat4(const std::string& name, const glm::mat4& matrix) const
+void Shader::setMat4(std::string_view name, const glm::mat4& matrix) const
 {
-	int location = glGetUniformLocation(ID, name.c_str());
+	GLint location = getUniformLocation(name);
 	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
\ No newline at end of file
@@ -2,10 +2,20 @@
 
 #include <glad/glad.h>
 #include <string>
+#include <string_view>
+#include <functional>
 #include <iostream>
+#include <vector>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 std::string get_file_contents(const char* filename);
+// Reads a shader file and expands its #include "file" directives (each file is included once).
+// Includes are looked up next to the including file, then in shaders/include/.
+// Every file that was read is appended to dependencies (used for hot reload).
+std::string get_shader_source(const char* filename, std::vector<std::string>* dependencies = nullptr);
+// Makes a generated source available to #include under the given name (e.g. "gpu_structs.glsl")
+void register_shader_include(const std::string& name, const std::string& contents);
 
 class Shader
 {
@@ -20,19 +30,35 @@ public:
 	
 	// Activates the Shader Program
 	void use();
-	// Deletes the Shader Program
+	// Releases the Shader Program (shared programs are deleted by the last user)
 	void destroy();
+	// Called by the ShaderRegistry when a hot reload replaced the program
+	void onProgramReloaded(GLuint newID);
 	// Dispatch compute shader
-	void dispatch(GLuint num_groups_x, GLuint num_groups_y = 1, GLuint num_groups_z = 1);	// utility uniform functions
+	void dispatch(GLuint num_groups_x, GLuint num_groups_y = 1, GLuint num_groups_z = 1);
+	// Dispatch compute shader with the group counts stored in a buffer by an earlier pass
+	void dispatchIndirect(GLuint buffer, GLintptr offset = 0);
+	// utility uniform functions
 	//void setBool(const std::string& name, bool value) const; // Apparently I can't do that?!?
-	void setInt(const std::string& name, int value) const;
-	void setFloat(const std::string& name, float value) const;
-	void setVec2(const std::string& name, float x, float y) const;
-	void setVec2(const std::string& name, glm::vec2 vector) const;
-	//void setVec2Array(const std::string& name, const float size, std::vector<glm::vec2> vector) const;
-	void setVec3(const std::string& name, float x, float y, float z) const;
-	void setVec3(const std::string& name, glm::vec3 vector) const;
-	void setVec4(const std::string& name, float x, float y, float z, float w) const;
-	void setMat4(const std::string& name, const glm::mat4& matrix) const;
+	void setInt(std::string_view name, int value) const;
+	void setFloat(std::string_view name, float value) const;
+	void setVec2(std::string_view name, float x, float y) const;
+	void setVec2(std::string_view name, glm::vec2 vector) const;
+	//void setVec2Array(std::string_view name, const float size, std::vector<glm::vec2> vector) const;
+	void setVec3(std::string_view name, float x, float y, float z) const;
+	void setVec3(std::string_view name, glm::vec3 vector) const;
+	void setVec4(std::string_view name, float x, float y, float z, float w) const;
+	void setMat4(std::string_view name, const glm::mat4& matrix) const;
+	// Looks up a uniform location, cached by name so per-frame setters skip glGetUniformLocation
+	GLint getUniformLocation(std::string_view name) const;
+
+private:
+	// Transparent hash, so lookups take the string_view without building a std::string
+	struct UniformNameHash
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+	};
+	mutable std::unordered_map<std::string, GLint, UniformNameHash, std::equal_to<>> uniformLocations;
 
 };
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "shader_registry.h"
+#include "shader_class.h"
+#include <GLFW/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	// On-disk header for cached program binaries
+	struct ProgramBinaryHeader
+	{
+		uint32_t magic;         // 'BSPB'
+		uint32_t version;       // Bump when the header layout changes
+		uint64_t driverHash;    // Hash of GL_VENDOR/GL_RENDERER/GL_VERSION
+		uint64_t sourceHash;    // Hash of all stage sources
+		uint32_t binaryFormat;  // Driver specific format returned by glGetProgramBinary
+		uint32_t binaryLength;  // Size of the blob following the header
+	};
+
+	constexpr uint32_t PROGRAM_BINARY_MAGIC = 0x42505342; // "BSPB"
+	constexpr uint32_t PROGRAM_BINARY_VERSION = 1;
+
+	// 64-bit FNV-1a, stable across runs and platforms
+	uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	const char* stageName(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_VERTEX_SHADER: return "VERTEX";
+		case GL_FRAGMENT_SHADER: return "FRAGMENT";
+		case GL_COMPUTE_SHADER: return "COMPUTE";
+		default: return "UNKNOWN";
+		}
+	}
+
+	constexpr double HOT_RELOAD_INTERVAL = 0.5; // Seconds between file time checks
+
+	std::filesystem::file_time_type lastWriteTime(const std::string& path)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		return error ? std::filesystem::file_time_type::min() : time;
+	}
+}
+
+GLuint ShaderRegistry::acquire(const std::vector<ShaderStageSource>& stages, Shader* user)
+{
+	// Programs are only shared within the GL context that created them
+	char contextTag[32];
+	std::snprintf(contextTag, sizeof(contextTag), "%p", static_cast<void*>(glfwGetCurrentContext()));
+	std::string key = contextTag;
+	for (const ShaderStageSource& stage : stages)
+	{
+		key += "|" + std::to_string(stage.type) + ":" + stage.path;
+	}
+
+	auto existing = programs.find(key);
+	if (existing != programs.end())
+	{
+		existing->second.refCount++;
+		if (user) existing->second.users.push_back(user);
+		sharedCount++;
+		return existing->second.program;
+	}
+
+	std::vector<std::string> sources;
+	std::vector<std::string> dependencies;
+	uint64_t sourceHash = readSources(stages, sources, dependencies);
+
+	GLuint program = 0;
+	if (binaryCacheEnabled)
+	{
+		program = glCreateProgram();
+		if (loadBinary(program, sourceHash))
+		{
+			cacheHitCount++;
+		}
+		else
+		{
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+
+	if (program == 0)
+	{
+		program = compileFromSource(stages, sources);
+		compiledCount++;
+
+		int success;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (success && binaryCacheEnabled)
+		{
+			saveBinary(program, sourceHash);
+		}
+	}
+
+	Entry entry;
+	entry.program = program;
+	entry.refCount = 1;
+	for (const ShaderStageSource& stage : stages)
+	{
+		entry.stageTypes.push_back(stage.type);
+		entry.stagePaths.push_back(stage.path);
+	}
+	for (const std::string& dependency : dependencies)
+	{
+		entry.writeTimes.push_back(lastWriteTime(dependency));
+	}
+	entry.dependencies = std::move(dependencies);
+	if (user) entry.users.push_back(user);
+
+	programs[key] = std::move(entry);
+	keysByProgram[program] = key;
+	return program;
+}
+
+void ShaderRegistry::release(GLuint program, Shader* user)
+{
+	auto keyIt = keysByProgram.find(program);
+	if (keyIt == keysByProgram.end())
+	{
+		// Not created through the registry, just delete it
+		glDeleteProgram(program);
+		return;
+	}
+
+	auto entryIt = programs.find(keyIt->second);
+	if (entryIt != programs.end())
+	{
+		std::vector<Shader*>& users = entryIt->second.users;
+		users.erase(std::remove(users.begin(), users.end(), user), users.end());
+		if (--entryIt->second.refCount > 0)
+		{
+			return;
+		}
+	}
+
+	glDeleteProgram(program);
+	if (entryIt != programs.end())
+	{
+		programs.erase(entryIt);
+	}
+	keysByProgram.erase(keyIt);
+}
+
+void ShaderRegistry::pollHotReload()
+{
+	double now = glfwGetTime();
+	if (now - lastReloadPoll < HOT_RELOAD_INTERVAL)
+	{
+		return;
+	}
+	lastReloadPoll = now;
+
+	for (auto& [key, entry] : programs)
+	{
+		bool changed = false;
+		for (size_t i = 0; i < entry.dependencies.size(); i++)
+		{
+			auto time = lastWriteTime(entry.dependencies[i]);
+			if (time != entry.writeTimes[i])
+			{
+				entry.writeTimes[i] = time;
+				changed = true;
+			}
+		}
+		if (changed)
+		{
+			reload(entry);
+		}
+	}
+}
+
+void ShaderRegistry::reload(Entry& entry)
+{
+	std::vector<ShaderStageSource> stages;
+	for (size_t i = 0; i < entry.stageTypes.size(); i++)
+	{
+		stages.push_back({ entry.stageTypes[i], entry.stagePaths[i].c_str() });
+	}
+
+	std::vector<std::string> sources;
+	std::vector<std::string> dependencies;
+	uint64_t sourceHash = 0;
+	try
+	{
+		sourceHash = readSources(stages, sources, dependencies);
+	}
+	catch (int)
+	{
+		return; // File missing mid-save, try again on the next change
+	}
+
+	GLuint program = compileFromSource(stages, sources);
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Warning: hot reload of " << entry.stagePaths.front() << " failed, keeping the previous program\n";
+		glDeleteProgram(program);
+		return;
+	}
+
+	if (binaryCacheEnabled)
+	{
+		saveBinary(program, sourceHash);
+	}
+
+	// Swap the program for every Shader sharing it
+	std::string key = keysByProgram[entry.program];
+	keysByProgram.erase(entry.program);
+	glDeleteProgram(entry.program);
+	entry.program = program;
+	keysByProgram[program] = key;
+	for (Shader* user : entry.users)
+	{
+		user->onProgramReloaded(program);
+	}
+
+	// Includes may have been added or removed
+	entry.writeTimes.clear();
+	for (const std::string& dependency : dependencies)
+	{
+		entry.writeTimes.push_back(lastWriteTime(dependency));
+	}
+	entry.dependencies = std::move(dependencies);
+
+	reloadCount++;
+	std::cout << "Reloaded shader " << entry.stagePaths.front() << "\n";
+}
+
+uint64_t ShaderRegistry::readSources(const std::vector<ShaderStageSource>& stages, std::vector<std::string>& sources, std::vector<std::string>& dependencies)
+{
+	// Read all stage sources (with includes expanded) and hash them together with their stage types
+	uint64_t sourceHash = hashBytes(nullptr, 0);
+	for (const ShaderStageSource& stage : stages)
+	{
+		sources.push_back(get_shader_source(stage.path, &dependencies));
+		sourceHash = hashBytes(&stage.type, sizeof(stage.type), sourceHash);
+		sourceHash = hashBytes(sources.back().data(), sources.back().size(), sourceHash);
+	}
+	return sourceHash;
+}
+
+GLuint ShaderRegistry::compileFromSource(const std::vector<ShaderStageSource>& stages, const std::vector<std::string>& sources)
+{
+	int success;
+	char infoLog[512];
+
+	GLuint program = glCreateProgram();
+	// Ask the driver to keep the binary around so it can be cached
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	std::vector<GLuint> shaderObjects;
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		const char* source = sources[i].c_str();
+		GLuint shader = glCreateShader(stages[i].type);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(shader, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::" << stageName(stages[i].type) << "::COMPILATION_FAILED (" << stages[i].path << ")\n" << infoLog << "\n";
+		}
+		glAttachShader(program, shader);
+		shaderObjects.push_back(shader);
+	}
+
+	glLinkProgram(program);
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(program, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED (" << stages.front().path << ")\n" << infoLog << "\n";
+	}
+
+	// destroy the now useless shader objects
+	for (GLuint shader : shaderObjects)
+	{
+		glDetachShader(program, shader);
+		glDeleteShader(shader);
+	}
+
+	return program;
+}
+
+bool ShaderRegistry::loadBinary(GLuint program, uint64_t sourceHash)
+{
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+	std::ifstream file(std::filesystem::path(cacheDirectory) / fileName, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	ProgramBinaryHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	getDriverString();
+	if (!file || header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION ||
+		header.driverHash != driverHash || header.sourceHash != sourceHash || header.binaryLength == 0)
+	{
+		return false; // Stale entry (different driver or sources), fall back to source
+	}
+
+	std::vector<char> blob(header.binaryLength);
+	file.read(blob.data(), blob.size());
+	if (!file)
+	{
+		return false;
+	}
+
+	glProgramBinary(program, header.binaryFormat, blob.data(), static_cast<GLsizei>(blob.size()));
+
+	// The driver may still reject a binary (e.g. after a silent driver update)
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	return success != 0;
+}
+
+void ShaderRegistry::saveBinary(GLuint program, uint64_t sourceHash)
+{
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0)
+	{
+		return; // Driver does not support program binaries
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> blob(length);
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(program, length, nullptr, &binaryFormat, blob.data());
+
+	std::error_code error;
+	std::filesystem::create_directories(cacheDirectory, error);
+	if (error)
+	{
+		std::cout << "Warning: could not create shader cache directory " << cacheDirectory << "\n";
+		return;
+	}
+
+	getDriverString();
+	ProgramBinaryHeader header{};
+	header.magic = PROGRAM_BINARY_MAGIC;
+	header.version = PROGRAM_BINARY_VERSION;
+	header.driverHash = driverHash;
+	header.sourceHash = sourceHash;
+	header.binaryFormat = binaryFormat;
+	header.binaryLength = static_cast<uint32_t>(length);
+
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+	std::ofstream file(std::filesystem::path(cacheDirectory) / fileName, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(blob.data(), blob.size());
+}
+
+const std::string& ShaderRegistry::getDriverString()
+{
+	if (driverString.empty())
+	{
+		const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+		const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		driverString = std::string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "");
+		driverHash = hashBytes(driverString.data(), driverString.size());
+	}
+	return driverString;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+
+class Shader;
+
+// A single stage of a shader program (e.g. GL_VERTEX_SHADER + path)
+struct ShaderStageSource
+{
+	GLenum type;
+	const char* path;
+};
+
+// Shared registry of linked shader programs.
+// Every Shader constructor goes through here, so a program used by several CellManagers
+// is compiled once per GL context and reference counted until the last user destroys it.
+// Linked programs are also persisted as glGetProgramBinary blobs in the cache directory,
+// keyed by a hash of the shader sources and the driver string, so repeat launches skip compilation.
+// If a cached binary is stale or rejected by the driver, the program is rebuilt from source.
+// Sources go through get_shader_source, so the hash and the hot reload watch list cover #included files.
+class ShaderRegistry
+{
+public:
+	static ShaderRegistry& instance() {
+		static ShaderRegistry inst;
+		return inst;
+	}
+
+	// Returns a linked program for these stages, compiling or loading it if needed
+	GLuint acquire(const std::vector<ShaderStageSource>& stages, Shader* user = nullptr);
+	// Drops one reference to a program; the program is deleted when nobody uses it anymore
+	void release(GLuint program, Shader* user = nullptr);
+
+	// Recompiles programs whose source or included files changed on disk (throttled, call once per frame).
+	// A program is only swapped in if it links, so a typo while editing keeps the old program running.
+	void pollHotReload();
+
+	void setCacheDirectory(const std::string& directory) { cacheDirectory = directory; }
+	void setBinaryCacheEnabled(bool enabled) { binaryCacheEnabled = enabled; }
+
+	// Startup statistics
+	int getCompiledCount() const { return compiledCount; }
+	int getCacheHitCount() const { return cacheHitCount; }
+	int getSharedCount() const { return sharedCount; }
+	int getReloadCount() const { return reloadCount; }
+
+private:
+	ShaderRegistry() = default;
+
+	struct Entry {
+		GLuint program = 0;
+		int refCount = 0;
+		std::vector<GLenum> stageTypes;
+		std::vector<std::string> stagePaths;
+		std::vector<std::string> dependencies;                      // Stage files and everything they include
+		std::vector<std::filesystem::file_time_type> writeTimes;    // Last seen write time per dependency
+		std::vector<Shader*> users;                                 // Updated when the program is hot reloaded
+	};
+
+	GLuint compileFromSource(const std::vector<ShaderStageSource>& stages, const std::vector<std::string>& sources);
+	uint64_t readSources(const std::vector<ShaderStageSource>& stages, std::vector<std::string>& sources, std::vector<std::string>& dependencies);
+	void reload(Entry& entry);
+	bool loadBinary(GLuint program, uint64_t sourceHash);
+	void saveBinary(GLuint program, uint64_t sourceHash);
+	const std::string& getDriverString();
+
+	std::unordered_map<std::string, Entry> programs;        // Key: GL context + stage paths
+	std::unordered_map<GLuint, std::string> keysByProgram;  // Reverse lookup for release()
+
+	std::string cacheDirectory = "shader_cache";
+	bool binaryCacheEnabled = true;
+	std::string driverString;
+	uint64_t driverHash = 0;
+
+	int compiledCount = 0;
+	int cacheHitCount = 0;
+	int sharedCount = 0;
+	int reloadCount = 0;
+	double lastReloadPoll = 0.0;
+};
@@ -77,6 +77,17 @@ public:
         }
     }
     void resetPreviewSimulationTime() { previewSimulationTime = 0.0f; }
+    
+    // Main simulation time tracking (saved in checkpoints)
+    double getMainSimulationTime() const { return mainSimulationTime; }
+    void setMainSimulationTime(double time) { mainSimulationTime = time; }
+    void updateMainSimulationTime(float deltaTime)
+    {
+        if (!paused && currentScene == Scene::MainSimulation)
+        {
+            mainSimulationTime += deltaTime;
+        }
+    }
 
     const char* getSceneName(Scene scene) const
     {
@@ -108,6 +119,7 @@ private:
     bool paused = false;
     float simulationSpeed = 1.0f;
     float previewSimulationTime = 0.0f;  // Track time in preview simulation
+    double mainSimulationTime = 0.0;     // Track time in main simulation (double so multi-hour runs keep step precision)
     
     // Per-scene pause states
     bool previewPaused = true;   // Preview starts paused
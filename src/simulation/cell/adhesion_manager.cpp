@@ -1,5 +1,4 @@
 #include "cell_manager.h"
-#include "../../rendering/camera/camera.h"
 #include "../../core/config.h"
 #include "../../ui/ui_manager.h"
 #include <iostream>
@@ -19,88 +18,24 @@
 
 void CellManager::initializeAdhesionLineBuffers()
 {
-    // Create buffer for adhesionSettings line vertices (each line has 2 vertices)
-    // Each vertex has vec4 position + vec4 color = 8 floats = 32 bytes
-    glCreateBuffers(1, &adhesionLineBuffer);
-    glNamedBufferData(adhesionLineBuffer,
-        cellLimit * 2 * sizeof(glm::vec4) * 2, // 2 vertices per line, position + color for each vertex
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
-    
-    // Create VAO for adhesionSettings line rendering
+    // Adhesion lines are generated in adhesion_line.vert from the connection and cell buffers
+    // (2 vertices per connection), so only an empty VAO is needed for the core profile.
     glCreateVertexArrays(1, &adhesionLineVAO);
-    
-    // Create VBO that will be bound to the adhesionSettings line buffer
-    glCreateBuffers(1, &adhesionLineVBO);
-    glNamedBufferData(adhesionLineVBO,
-        cellLimit * 2 * sizeof(glm::vec4) * 2,
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
-    
-    // Set up VAO with vertex attributes (stride is now 2 vec4s = 32 bytes)
-    glVertexArrayVertexBuffer(adhesionLineVAO, 0, adhesionLineVBO, 0, sizeof(glm::vec4) * 2);
-    
-    // Position attribute (vec4)
-    glEnableVertexArrayAttrib(adhesionLineVAO, 0);
-    glVertexArrayAttribFormat(adhesionLineVAO, 0, 4, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(adhesionLineVAO, 0, 0);
-    
-    // Color attribute (vec4, offset by 16 bytes)
-    glEnableVertexArrayAttrib(adhesionLineVAO, 1);
-    glVertexArrayAttribFormat(adhesionLineVAO, 1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4));
-    glVertexArrayAttribBinding(adhesionLineVAO, 1, 0);
-}
-
-void CellManager::updateAdhesionLineData()
-{
-    if (adhesionCount == 0) return;
-
-    TimerGPU timer("Adhesion Data Update");
-
-    adhesionLineExtractShader->use();
-
-    // Bind cell data as input
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
-    // Bind adhesionSettings connection buffer as input
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, adhesionConnectionBuffer);
-    // Bind adhesionSettings line buffer as output
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, adhesionLineBuffer);
-    // Bind cell count buffer
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gpuCellCountBuffer);
-
-    // Dispatch compute shader
-    GLuint numGroups = (adhesionCount + 63) / 64;
-    adhesionLineExtractShader->dispatch(numGroups, 1, 1);
-
-    // Use targeted barrier for buffer copy
-    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    flushBarriers();
-
-    // Copy data from compute buffer to VBO for rendering
-    glCopyNamedBufferSubData(adhesionLineBuffer, adhesionLineVBO, 0, 0, adhesionCount * 2 * sizeof(glm::vec4) * 2);
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void CellManager::renderAdhesionLines(glm::vec2 resolution, const Camera& camera, bool showAdhesionLines)
+void CellManager::renderAdhesionLines(bool showAdhesionLines)
 {
     if (!showAdhesionLines || adhesionCount == 0) return;
 
-    updateAdhesionLineData();
-
     TimerGPU timer("Adhesion Rendering");
 
     adhesionLineShader->use();
 
-    // Set up camera matrices
-    glm::mat4 view = camera.getViewMatrix();
-    float aspectRatio = resolution.x / resolution.y;
-    if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio))
-    {
-        aspectRatio = 16.0f / 9.0f;
-    }
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
+    // Vertex shader pulls line endpoints from the connection and cell buffers
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, adhesionConnectionBuffer);
 
-    adhesionLineShader->setMat4("uProjection", projection);
-    adhesionLineShader->setMat4("uView", view);
+    // Camera matrices come from the FrameConstants block
 
     // Enable depth testing and depth writing for proper depth sorting with ring gizmos
     glEnable(GL_DEPTH_TEST);
@@ -118,16 +53,6 @@ void CellManager::renderAdhesionLines(glm::vec2 resolution, const Camera& camera
 
 void CellManager::cleanupAdhesionLines()
 {
-    if (adhesionLineBuffer != 0)
-    {
-        glDeleteBuffers(1, &adhesionLineBuffer);
-        adhesionLineBuffer = 0;
-    }
-    if (adhesionLineVBO != 0)
-    {
-        glDeleteBuffers(1, &adhesionLineVBO);
-        adhesionLineVBO = 0;
-    }
     if (adhesionLineVAO != 0)
     {
         glDeleteVertexArrays(1, &adhesionLineVAO);
@@ -142,12 +67,11 @@ void CellManager::initializeAdhesionConnectionSystem()
 {
     // Create buffer for adhesionSettings connections
     // Each connection stores: cellAIndex, cellBIndex, modeIndex, isActive (4 uints = 16 bytes)
-    glCreateBuffers(1, &adhesionConnectionBuffer);
-    glNamedBufferData(adhesionConnectionBuffer,
-        cellLimit * sizeof(AdhesionConnection),
-        nullptr, GL_DYNAMIC_READ);  // GPU produces data, CPU reads for connection count
+    adhesionConnectionBuffer = bufferArena.createBuffer(GPUSubsystem::Adhesion,
+        cellCapacity * config::ADHESIONS_PER_CELL * sizeof(AdhesionConnection),
+        GL_DYNAMIC_STORAGE_BIT);  // GPU produces data, restored from the CPU for keyframes
     
-    std::cout << "Initialized adhesionSettings connection system with capacity for " << cellLimit << " connections\n";
+    std::cout << "Initialized adhesionSettings connection system with capacity for " << cellCapacity * config::ADHESIONS_PER_CELL << " connections\n";
 }
 
 void CellManager::runAdhesionPhysics()
@@ -157,19 +81,13 @@ void CellManager::runAdhesionPhysics()
     TimerGPU timer("Adhesion Physics");
     
     adhesionPhysicsShader->use();
-    
-    // Set uniforms
-    adhesionPhysicsShader->setInt("u_gridResolution", config::GRID_RESOLUTION);
-    adhesionPhysicsShader->setFloat("u_gridCellSize", config::GRID_CELL_SIZE);
-    adhesionPhysicsShader->setFloat("u_worldSize", config::WORLD_SIZE);
-    adhesionPhysicsShader->setInt("u_maxCellsPerGrid", config::MAX_CELLS_PER_GRID);
-    adhesionPhysicsShader->setInt("u_maxConnections", cellLimit);
+    bindSimulationConstants(); // Grid settings and connection limit (also called from the genome editor)
     
     // Bind buffers
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellWriteBuffer()); // Cell data
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, modeBuffer); // Mode data
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gridBuffer); // Spatial grid
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gridCountBuffer); // Grid counts
+    gridBuffer.bindStorage(2); // Spatial grid
+    gridCountBuffer.bindStorage(3); // Grid counts
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, adhesionConnectionBuffer); // Output connections
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, gpuCellCountBuffer); // Cell count
     
@@ -182,11 +100,7 @@ void CellManager::runAdhesionPhysics()
 
 void CellManager::cleanupAdhesionConnectionSystem()
 {
-    if (adhesionConnectionBuffer != 0)
-    {
-        glDeleteBuffers(1, &adhesionConnectionBuffer);
-        adhesionConnectionBuffer = 0;
-    }
+    bufferArena.destroyBuffer(adhesionConnectionBuffer);
     adhesionCount = 0;
 }
 
@@ -206,38 +120,12 @@ std::vector<AdhesionConnection> CellManager::getAdhesionConnections() const
     addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     flushBarriers();
     
-    // Create a staging buffer for adhesion connections
-    GLuint stagingBuffer;
-    glCreateBuffers(1, &stagingBuffer);
-    glNamedBufferStorage(
-        stagingBuffer,
-        adhesionCount * sizeof(AdhesionConnection),
-        nullptr,
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT
-    );
-    
-    // Copy adhesion connections from GPU to staging buffer
-    glCopyNamedBufferSubData(adhesionConnectionBuffer, stagingBuffer, 0, 0, adhesionCount * sizeof(AdhesionConnection));
-    
-    // Map the staging buffer for reading
-    void* mappedPtr = glMapNamedBufferRange(stagingBuffer, 0, adhesionCount * sizeof(AdhesionConnection),
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-    
-    if (mappedPtr) {
-        AdhesionConnection* connectionData = static_cast<AdhesionConnection*>(mappedPtr);
-        
-        // Copy connections to vector
-        connections.reserve(adhesionCount);
-        for (int i = 0; i < adhesionCount; i++) {
-            connections.push_back(connectionData[i]);
-        }
-        
-        glUnmapNamedBuffer(stagingBuffer);
+    // Copied through a pooled staging buffer, straight into the vector
+    connections.resize(adhesionCount);
+    if (!readbackPool.read(adhesionConnectionBuffer, 0, adhesionCount * sizeof(AdhesionConnection), connections.data())) {
+        connections.clear();
     }
     
-    // Cleanup staging buffer
-    glDeleteBuffers(1, &stagingBuffer);
-    
     return connections;
 }
 
@@ -250,6 +138,11 @@ void CellManager::restoreAdhesionConnections(const std::vector<AdhesionConnectio
         return;
     }
     
+    if (!reserveCellCapacity((count + config::ADHESIONS_PER_CELL - 1) / config::ADHESIONS_PER_CELL)) { // The connection buffer grows with the cell buffers
+        std::cout << "Warning: Restoration adhesion count exceeds limit!\n";
+        return;
+    }
+
     // Update adhesion count
     adhesionCount = count;
     
@@ -260,8 +153,7 @@ void CellManager::restoreAdhesionConnections(const std::vector<AdhesionConnectio
                          connections.data());
     
     // Update the GPU cell count buffer to include adhesion count
-    GLuint counts[3] = { static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(pendingCellCount) };
-    glNamedBufferSubData(gpuCellCountBuffer, 0, sizeof(GLuint) * 3, counts);
+    setGPUCounts({ static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(cellCount), 0u });
     
     // Ensure GPU buffers are synchronized
     addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
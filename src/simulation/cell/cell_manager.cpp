@@ -7,6 +7,7 @@
 #include <cfloat>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -28,6 +29,7 @@ CellManager::CellManager()
     sphereMesh.setupBuffers();
 
     initializeGPUBuffers();
+    initializeConstantBuffers();
     initializeSpatialGrid();
 
     // Initialize compute shaders
@@ -36,6 +38,9 @@ CellManager::CellManager()
     internalUpdateShader = new Shader("shaders/cell/physics/cell_update_internal.comp");
     extractShader = new Shader("shaders/cell/management/extract_instances.comp");
     cellAdditionShader = new Shader("shaders/cell/management/apply_additions.comp");
+    spawnShader = new Shader("shaders/cell/management/spawn_cells.comp");
+    stepDispatchShader = new Shader("shaders/cell/management/step_dispatch.comp");
+    cellReadback.initialize();
 
     // Initialize spatial grid shaders
     gridClearShader = new Shader("shaders/spatial/grid_clear.comp");
@@ -43,16 +48,13 @@ CellManager::CellManager()
     gridPrefixSumShader = new Shader("shaders/spatial/grid_prefix_sum.comp");
     gridInsertShader = new Shader("shaders/spatial/grid_insert.comp");
     
-    // Initialize gizmo shaders
-    gizmoExtractShader = new Shader("shaders/rendering/debug/gizmo_extract.comp");
+    // Initialize gizmo shaders (vertices are pulled from the cell buffer by gl_VertexID)
     gizmoShader = new Shader("shaders/rendering/debug/gizmo.vert", "shaders/rendering/debug/gizmo.frag");
     
     // Initialize ring gizmo shaders
-    ringGizmoExtractShader = new Shader("shaders/rendering/debug/ring_gizmo_extract.comp");
     ringGizmoShader = new Shader("shaders/rendering/debug/ring_gizmo.vert", "shaders/rendering/debug/ring_gizmo.frag");
     
     // Initialize adhesionSettings line shaders
-    adhesionLineExtractShader = new Shader("shaders/rendering/debug/adhesion_line_extract.comp");
     adhesionLineShader = new Shader("shaders/rendering/debug/adhesion_line.vert", "shaders/rendering/debug/adhesion_line.frag");
     
     // Initialize adhesionSettings physics  shader
@@ -91,43 +93,21 @@ void CellManager::cleanup()
     // Clean up triple buffered cell buffers
     for (int i = 0; i < 3; i++)
     {
-        if (cellBuffer[i] != 0)
-        {
-            glDeleteBuffers(1, &cellBuffer[i]);
-            cellBuffer[i] = 0;
-        }
-    }
-    if (instanceBuffer != 0)
-    {
-        glDeleteBuffers(1, &instanceBuffer);
-        instanceBuffer = 0;
-    }
-    if (modeBuffer != 0)
-    {
-        glDeleteBuffers(1, &modeBuffer);
-        modeBuffer = 0;
-    }
-    if (gpuCellCountBuffer != 0)
-    {
-        glDeleteBuffers(1, &gpuCellCountBuffer);
-        gpuCellCountBuffer = 0;
-    }
-    if (stagingCellCountBuffer != 0)
-    {
-        glDeleteBuffers(1, &stagingCellCountBuffer);
-        stagingCellCountBuffer = 0;
-    }
-    if (stagingCellBuffer != 0)
-    {
-        glDeleteBuffers(1, &stagingCellBuffer);
-        stagingCellBuffer = 0;
-    }
-    if (cellAdditionBuffer != 0)
-    {
-        glDeleteBuffers(1, &cellAdditionBuffer);
-        cellAdditionBuffer = 0;
+        bufferArena.destroyBuffer(cellBuffer[i]);
     }
-
+    bufferArena.destroyBuffer(instanceBuffer);
+    bufferArena.destroyBuffer(modeBuffer);
+    modeCapacity = 0;
+    bufferArena.destroyBuffer(reachedModesBuffer);
+    bufferArena.destroyBuffer(simulationCellCountBuffer);
+    bufferArena.destroyBuffer(gpuCellCountBuffer);
+    bufferArena.destroyBuffer(stepDispatchBuffer);
+    countSnapshots.release(bufferArena);
+    cellUploadRing.release(bufferArena);
+    cellReadback.release(readbackPool);
+    readbackPool.releaseAll();
+
+    cleanupConstantBuffers();
     cleanupSpatialGrid();
     cleanupLODSystem();
     cleanupUnifiedCulling();
@@ -151,6 +131,18 @@ void CellManager::cleanup()
         delete updateShader;
         updateShader = nullptr;
     }
+    if (spawnShader)
+    {
+        spawnShader->destroy();
+        delete spawnShader;
+        spawnShader = nullptr;
+    }
+    if (stepDispatchShader)
+    {
+        stepDispatchShader->destroy();
+        delete stepDispatchShader;
+        stepDispatchShader = nullptr;
+    }
 
     // Cleanup spatial grid shaders
     if (gridClearShader)
@@ -179,24 +171,12 @@ void CellManager::cleanup()
     }
     
     // Cleanup gizmo shaders
-    if (gizmoExtractShader)
-    {
-        gizmoExtractShader->destroy();
-        delete gizmoExtractShader;
-        gizmoExtractShader = nullptr;
-    }
     if (gizmoShader)
     {
         gizmoShader->destroy();
         delete gizmoShader;
         gizmoShader = nullptr;
     }
-    if (ringGizmoExtractShader)
-    {
-        ringGizmoExtractShader->destroy();
-        delete ringGizmoExtractShader;
-        ringGizmoExtractShader = nullptr;
-    }
     if (ringGizmoShader)
     {
         ringGizmoShader->destroy();
@@ -230,150 +210,335 @@ void CellManager::cleanup()
 // ============================================================================
 
 void CellManager::initializeGPUBuffers()
-{    // Create triple buffered compute buffers for cell data
+{
+    // Every buffer goes through the arena, which refuses allocations past the budget
+    bufferArena.setBudget(static_cast<size_t>(config::CELL_MANAGER_GPU_BUDGET_MB) * 1024 * 1024);
+
+    // Per-cell buffers start small and grow with the population (see reserveCellCapacity)
+    cellCapacity = std::max(1, std::min(cellLimit, config::INITIAL_CELL_CAPACITY));
+
+    // Create triple buffered compute buffers for cell data
+    std::vector<ComputeCell> zeroCells(cellCapacity);
     for (int i = 0; i < 3; i++)
     {
-        std::vector<ComputeCell> zeroCells(cellLimit);
-        glCreateBuffers(1, &cellBuffer[i]);
-        glNamedBufferData(
-            cellBuffer[i],
-            cellLimit * sizeof(ComputeCell),
-            zeroCells.data(),
-            GL_DYNAMIC_COPY  // Used by both GPU compute and CPU read operations
+        cellBuffer[i] = bufferArena.createBuffer(GPUSubsystem::Cells,
+            cellCapacity * sizeof(ComputeCell),
+            GL_DYNAMIC_STORAGE_BIT,  // Written by the CPU when cells are added or edited
+            zeroCells.data()
         );
     }
 
     // Create instance buffer for rendering (contains position + radius + color + orientation)
-    glCreateBuffers(1, &instanceBuffer);
-    glNamedBufferData(
-        instanceBuffer,
-        cellLimit * sizeof(glm::vec4) * 3, // 3 vec4s: positionAndRadius, color, orientation
-        nullptr,
-        GL_DYNAMIC_COPY  // GPU produces data, GPU consumes for rendering
+    instanceBuffer = bufferArena.createBuffer(GPUSubsystem::Instances,
+        cellCapacity * sizeof(glm::vec4) * 3, // 3 vec4s: positionAndRadius, color, orientation
+        0  // GPU produces data, GPU consumes for rendering
     );
 
-    // Create single buffered genome buffer
-    glCreateBuffers(1, &modeBuffer);
-    glNamedBufferData(modeBuffer,
-        cellLimit * sizeof(GPUMode),
-        nullptr,
-        GL_DYNAMIC_COPY  // Written once by CPU, read frequently by GPU compute shaders
-    );
+    // Mode buffer and reached-mode bitfield, sized to the genome table and grown when genomes are added
+    ensureModeCapacity(config::INITIAL_MODE_CAPACITY);
+
+    // Per-simulation cell counts for ensemble mode (one unused counter until configureEnsemble)
+    simulationCellCountBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, sizeof(GLuint), GL_DYNAMIC_STORAGE_BIT);
+    glClearNamedBufferData(simulationCellCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
 
     // A buffer that keeps track of how many cells there are in the simulation
-    glCreateBuffers(1, &gpuCellCountBuffer);
-    glNamedBufferStorage(
-        gpuCellCountBuffer,
+    gpuCellCountBuffer = bufferArena.createBuffer(GPUSubsystem::Cells,
         sizeof(GLuint) * 4, // stores cellCount, adhesionCount, liveCellCount, liveAdhesionCount
-        nullptr,
         GL_DYNAMIC_STORAGE_BIT
     );
 
-    glCreateBuffers(1, &stagingCellCountBuffer);
-    glNamedBufferStorage(
-        stagingCellCountBuffer,
-        sizeof(GLuint) * 4,
-        nullptr,
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT
-    );
-    mappedPtr = glMapNamedBufferRange(stagingCellCountBuffer, 0, sizeof(GLuint) * 4,
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-    countPtr = static_cast<GLuint*>(mappedPtr);
-
-    // Cell data staging buffer for CPU reads (avoids GPU->CPU transfer warnings)
-    glCreateBuffers(1, &stagingCellBuffer);
-    glNamedBufferStorage(
-        stagingCellBuffer,
-        cellLimit * sizeof(ComputeCell),
-        nullptr,
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT
-    );
-    mappedCellPtr = glMapNamedBufferRange(stagingCellBuffer, 0, cellLimit * sizeof(ComputeCell),
-        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-
-    // Cell addition queue buffer - FIXED: Increased size for 100k cells
-    glCreateBuffers(1, &cellAdditionBuffer);
-    glNamedBufferData(cellAdditionBuffer,
-        cellLimit * sizeof(ComputeCell), // Full size to handle large simultaneous splits
-        nullptr,
-        GL_STREAM_COPY  // Frequently updated by GPU compute shaders
-    );
+    countSnapshots.initialize(bufferArena);
+
+    // The CPU count is a snapshot that can lag the GPU, so the per-cell passes are sized on the GPU
+    const GLuint initialDispatch[4] = { 0u, 1u, 1u, 0u };
+    stepDispatchBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, sizeof(initialDispatch), 0, initialDispatch);
 
     // NEW: Initialize stream compaction buffers
-    glCreateBuffers(1, &deadMarkersBuffer);
-    glNamedBufferData(deadMarkersBuffer,
-        cellLimit * sizeof(GLuint),
-        nullptr, GL_DYNAMIC_COPY);
+    deadMarkersBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, cellCapacity * sizeof(GLuint), 0);
+    prefixSumBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, cellCapacity * sizeof(GLuint), 0);
+    deadIndicesBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, cellCapacity * sizeof(GLuint), 0);
+
+    // Setup the sphere mesh to use our current instance buffer
+    sphereMesh.setupInstanceBuffer(instanceBuffer);
+}
 
-    glCreateBuffers(1, &prefixSumBuffer);
-    glNamedBufferData(prefixSumBuffer,
-        cellLimit * sizeof(GLuint),
-        nullptr, GL_DYNAMIC_COPY);
+// ============================================================================
+// CELL CAPACITY
+// ============================================================================
+// cellLimit is the most cells a scene may hold, cellCapacity is what the per-cell buffers are allocated for.
+// Capacity grows geometrically (with GPU-side copies of the buffers that hold state) as the population
+// approaches it, and drops back when the simulation is reset or the limit is lowered, so a 256 cell
+// preview only allocates a few hundred KB and the main scene can go past MAX_CELLS when memory allows.
 
-    glCreateBuffers(1, &deadIndicesBuffer);
-    glNamedBufferData(deadIndicesBuffer,
-        cellLimit * sizeof(GLuint),
-        nullptr, GL_DYNAMIC_COPY);
+void CellManager::setCellLimit(int limit)
+{
+    limit = std::max(limit, 1);
+    if (limit == cellLimit) {
+        return;
+    }
+    cellLimit = limit;
+    refusedCapacity = 0; // Worth trying again against the new limit
+
+    // The buffers only grow as far as the budget allows, so a limit past it can never be reached
+    size_t budget = bufferArena.getBudget();
+    if (budget > 0 && estimateGPUBytes(cellLimit) > budget) {
+        std::cout << "Warning: a cell limit of " << cellLimit << " needs about " << estimateGPUBytes(cellLimit) / (1024 * 1024)
+            << " MB of GPU memory, over the budget of " << budget / (1024 * 1024) << " MB\n";
+    }
 
-    // Setup the sphere mesh to use our current instance buffer
+    // Never shrink below what's already in the buffers
+    int needed = std::max(cellCount + pendingCellCount, adhesionCount);
+    if (cellCapacity > cellLimit && needed <= cellLimit) {
+        resizeCellBuffers(cellLimit);
+    }
+}
+
+bool CellManager::reserveCellCapacity(int cells)
+{
+    if (cells <= cellCapacity) {
+        return true;
+    }
+    if (cells > cellLimit) {
+        return false;
+    }
+
+    // Double (at least), but never past the limit or a size that was already refused
+    int newCapacity = std::min(cellLimit, std::max({ cells, cellCapacity * 2, config::INITIAL_CELL_CAPACITY }));
+    if (refusedCapacity > 0) {
+        newCapacity = std::max(cells, std::min(newCapacity, refusedCapacity - 1));
+    }
+    if (resizeCellBuffers(newCapacity)) {
+        return true;
+    }
+    // The doubling was only headroom, the exact size may still fit
+    return newCapacity > cells && resizeCellBuffers(cells);
+}
+
+std::vector<CellManager::PerCellBuffer> CellManager::getPerCellBuffers()
+{
+    std::vector<PerCellBuffer> buffers = {
+        { &cellBuffer[0], sizeof(ComputeCell), GPUSubsystem::Cells, GL_DYNAMIC_STORAGE_BIT, true, 0 },
+        { &cellBuffer[1], sizeof(ComputeCell), GPUSubsystem::Cells, GL_DYNAMIC_STORAGE_BIT, true, 0 },
+        { &cellBuffer[2], sizeof(ComputeCell), GPUSubsystem::Cells, GL_DYNAMIC_STORAGE_BIT, true, 0 },
+        { &adhesionConnectionBuffer, sizeof(AdhesionConnection) * config::ADHESIONS_PER_CELL, GPUSubsystem::Adhesion, GL_DYNAMIC_STORAGE_BIT, true, 0 },
+        { &instanceBuffer, sizeof(glm::vec4) * 3, GPUSubsystem::Instances, 0, false, 0 },
+        { &deadMarkersBuffer, sizeof(GLuint), GPUSubsystem::Cells, 0, false, 0 },
+        { &prefixSumBuffer, sizeof(GLuint), GPUSubsystem::Cells, 0, false, 0 },
+        { &deadIndicesBuffer, sizeof(GLuint), GPUSubsystem::Cells, 0, false, 0 },
+    };
+    for (int i = 0; i < 4; i++) {
+        buffers.push_back({ &lodInstanceBuffers[i], sizeof(float) * 12, GPUSubsystem::Instances, GL_DYNAMIC_STORAGE_BIT, false, 0 });
+    }
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
+        buffers.push_back({ &unifiedOutputBuffers[i], sizeof(float) * 16, GPUSubsystem::Instances, GL_DYNAMIC_STORAGE_BIT, false, 0 });
+    }
+    return buffers;
+}
+
+size_t CellManager::getBytesPerCell()
+{
+    size_t bytes = 0;
+    for (const PerCellBuffer& entry : getPerCellBuffers()) {
+        bytes += static_cast<size_t>(entry.bytesPerCell);
+    }
+    return bytes;
+}
+
+size_t CellManager::estimateGPUBytes(int cells)
+{
+    // Everything that doesn't follow the capacity (grid, modes, constants, ...) stays as it is
+    size_t bytesPerCell = getBytesPerCell();
+    size_t fixedBytes = bufferArena.getTotalBytes() - std::min(bufferArena.getTotalBytes(), bytesPerCell * static_cast<size_t>(cellCapacity));
+    return fixedBytes + bytesPerCell * static_cast<size_t>(std::max(cells, 0));
+}
+
+bool CellManager::fitsCellsAfterReset(int cells)
+{
+    int resetCapacity = std::max(1, std::min(cellLimit, config::INITIAL_CELL_CAPACITY));
+    if (cells <= resetCapacity) {
+        return true;
+    }
+    if (cells > cellLimit) {
+        return false;
+    }
+    // The reset frees the current per-cell buffers, then growing holds the reset-size and the new ones at once
+    size_t bytesPerCell = getBytesPerCell();
+    return bufferArena.fitsBudget(bytesPerCell * static_cast<size_t>(resetCapacity + cells), bytesPerCell * static_cast<size_t>(cellCapacity));
+}
+
+bool CellManager::resizeCellBuffers(int newCapacity)
+{
+    if (newCapacity == cellCapacity) {
+        return true;
+    }
+
+    TimerGPU gpuTimer("Resizing Cell Buffers");
+
+    // Make sure nothing still writes to the old buffers
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+
+    std::vector<PerCellBuffer> buffers = getPerCellBuffers();
+
+    // The old buffers are only freed after the copies, so both sets have to fit in the budget at once
+    size_t newBytes = static_cast<size_t>(newCapacity) * getBytesPerCell();
+    if (!bufferArena.fitsBudget(newBytes)) {
+        std::cout << "Warning: " << newCapacity << " cells would exceed the GPU memory budget, staying at " << cellCapacity << "\n";
+        refusedCapacity = refusedCapacity > 0 ? std::min(refusedCapacity, newCapacity) : newCapacity;
+        return false;
+    }
+
+    // Allocate every replacement first, so running out of memory leaves the old buffers untouched
+    bool allocated = true;
+    for (PerCellBuffer& entry : buffers) {
+        entry.replacement = bufferArena.createBuffer(entry.subsystem, static_cast<GLsizeiptr>(newCapacity) * entry.bytesPerCell, entry.flags);
+        if (entry.replacement == 0) {
+            allocated = false;
+            break;
+        }
+    }
+    if (!allocated) {
+        for (PerCellBuffer& entry : buffers) {
+            bufferArena.destroyBuffer(entry.replacement);
+        }
+        std::cout << "Warning: not enough GPU memory for " << newCapacity << " cells, staying at " << cellCapacity << "\n";
+        refusedCapacity = refusedCapacity > 0 ? std::min(refusedCapacity, newCapacity) : newCapacity;
+        return false;
+    }
+
+    int keptCells = std::min(cellCapacity, newCapacity);
+    for (PerCellBuffer& entry : buffers) {
+        if (entry.keepContents && keptCells > 0) {
+            glCopyNamedBufferSubData(*entry.buffer, entry.replacement, 0, 0, static_cast<GLsizeiptr>(keptCells) * entry.bytesPerCell);
+        }
+        bufferArena.destroyBuffer(*entry.buffer);
+        *entry.buffer = entry.replacement;
+    }
+
+    // Vertex attribute bindings refer to the old instance buffers
     sphereMesh.setupInstanceBuffer(instanceBuffer);
+    sphereMesh.setupLODInstanceBuffers(lodInstanceBuffers);
 
-    // Reserve CPU storage
-    cpuCells.reserve(cellLimit);
+    if (newCapacity < cellCapacity) {
+        refusedCapacity = 0; // Memory was freed, larger sizes may fit again
+    }
+    cellCapacity = newCapacity;
+    addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    return true;
 }
 
 // ============================================================================
-// CELL ADDITION & QUEUE MANAGEMENT
+// CELL COUNTS
 // ============================================================================
+// The counters live in gpuCellCountBuffer and are only ever read through fenced snapshots, so the CPU
+// never sees a value the copy hasn't finished writing.
 
-void CellManager::addCellsToQueueBuffer(const std::vector<ComputeCell> &cells)
-{ // Prefer to not use this directly, use addCellToStagingBuffer instead
-    int newCellCount = static_cast<int>(cells.size());
-
-    if (cellCount + newCellCount > cellLimit)
-    {
-        std::cout << "Warning: Maximum cell count reached!\n";
-        return;
+void CellManager::updateCounts(bool exact)
+{
+    // The copy has to see the counter writes of the passes before it
+    addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+
+    CellCounts counts;
+    if (exact) {
+        counts = countSnapshots.readExact(gpuCellCountBuffer);
+    } else {
+        countSnapshots.capture(gpuCellCountBuffer);
+        counts = countSnapshots.readLatest();
     }
 
-    TimerGPU gpuTimer("Adding Cells to GPU Buffers");
+    cellCount = static_cast<int>(counts.cellCount);
+    adhesionCount = static_cast<int>(counts.adhesionCount); // This is the number of adhesionSettings connections, not cells
+    liveCellCount = static_cast<int>(counts.liveCellCount);
+}
+
+void CellManager::setGPUCounts(const CellCounts& counts)
+{
+    glNamedBufferSubData(gpuCellCountBuffer, 0, sizeof(CellCounts), &counts);
+    countSnapshots.reset(counts);
+}
 
-    glNamedBufferSubData(cellAdditionBuffer,
-        0,
-        newCellCount * sizeof(ComputeCell),
-        cells.data());
+void CellManager::expectCellCount(int count)
+{
+    // Snapshots still in flight were taken before the pass and would report the old count
+    CellCounts counts = countSnapshots.readLatest();
+    counts.cellCount = static_cast<GLuint>(count);
+    countSnapshots.reset(counts);
+    cellCount = count;
 }
 
+// ============================================================================
+// CELL ADDITION & QUEUE MANAGEMENT
+// ============================================================================
+
 void CellManager::addCellToStagingBuffer(const ComputeCell &newCell)
 {
-    if (cellCount + 1 > cellLimit)
+    if (cellCount + pendingCellCount + 1 > cellLimit)
     {
         std::cout << "Warning: Maximum cell count reached!\n";
         return;
     }
 
-    // Create a copy of the cell and enforce radius = 1.0f
+    // Written straight into the mapped upload ring, the GPU picks it up on the next addStagedCellsToQueueBuffer
+    ComputeCell* slot = cellUploadRing.allocate(bufferArena, 1);
+    if (!slot)
+    {
+        std::cout << "Warning: no room left in the cell upload ring!\n";
+        return;
+    }
     ComputeCell correctedCell = newCell;
     correctedCell.positionAndMass.w = 1.0f; // Force all cells to have radius of 1
-
-    // Add to CPU storage only (no immediate GPU sync)
-    cellStagingBuffer.push_back(correctedCell);
-    cpuCells.push_back(correctedCell);
+    *slot = correctedCell;
     pendingCellCount++;
 }
 
+void CellManager::addCellsToStagingBuffer(const ComputeCell *cells, int count)
+{
+    if (count <= 0) return;
+    if (cellCount + pendingCellCount + count > cellLimit)
+    {
+        std::cout << "Warning: Maximum cell count reached!\n";
+        return;
+    }
+
+    ComputeCell* slots = cellUploadRing.allocate(bufferArena, count);
+    if (!slots)
+    {
+        std::cout << "Warning: no room left in the cell upload ring!\n";
+        return;
+    }
+    // One sequential pass over write-combined memory, each cell written whole
+    for (int i = 0; i < count; i++)
+    {
+        ComputeCell correctedCell = cells[i];
+        correctedCell.positionAndMass.w = 1.0f; // Force all cells to have radius of 1
+        slots[i] = correctedCell;
+    }
+    pendingCellCount += count;
+}
+
 void CellManager::addStagedCellsToQueueBuffer()
 {
-    if (cellStagingBuffer.empty()) return;
-    addCellsToQueueBuffer(cellStagingBuffer);
-    cellStagingBuffer.clear(); // Clear after adding to GPU buffer
+    if (pendingCellCount == 0) return;
+
+    // The additions go right after the last cell, so this needs the real count rather than a snapshot
+    updateCounts(true);
+
+    if (cellCount + pendingCellCount > cellLimit || !reserveCellCapacity(cellCount + pendingCellCount))
+    {
+        std::cout << "Warning: Maximum cell count reached!\n";
+        cellUploadRing.discardBatch();
+        pendingCellCount = 0;
+        return;
+    }
 
     addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
-    applyCellAdditions(); // Add the cells from gpu queue buffer to main cell buffers
+    applyCellAdditions(); // Add the cells from the upload ring to main cell buffers
+    cellUploadRing.submitBatch(); // Fenced behind the additions pass, so the range isn't overwritten early
 
-    // CRITICAL FIX: Update CPU-side cell count to match GPU after adding cells
-    updateCounts();
+    // apply_additions appends every pending cell (the limit was checked above)
+    expectCellCount(cellCount + pendingCellCount);
 
     pendingCellCount = 0;      // Reset pending count
 }
@@ -385,7 +550,7 @@ void CellManager::restoreCellsDirectlyToGPUBuffer(const std::vector<ComputeCell>
     
     int newCellCount = static_cast<int>(cells.size());
     
-    if (newCellCount > cellLimit) {
+    if (newCellCount > cellLimit || !reserveCellCapacity(newCellCount)) {
         std::cout << "Warning: Restoration cell count exceeds limit!\n";
         return;
     }
@@ -406,31 +571,121 @@ void CellManager::restoreCellsDirectlyToGPUBuffer(const std::vector<ComputeCell>
     
     // Update cell count directly
     cellCount = newCellCount;
-    GLuint counts[4] = { static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(cellCount), 0u }; // cellCount, adhesionCount, liveCellCount, liveAdhesionCount
-    glNamedBufferSubData(gpuCellCountBuffer, 0, sizeof(GLuint) * 4, counts);
-    
-    // Sync staging buffer
-    syncCounterBuffers();
+    setGPUCounts({ static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(cellCount), 0u });
     
-    // Clear addition buffer since we're not using it
-    glClearNamedBufferData(cellAdditionBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    // Cells staged before the restore are dropped
+    cellUploadRing.discardBatch();
     
     // Ensure GPU buffers are synchronized before proceeding
     glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
 }
 
-void CellManager::setCPUCellData(const std::vector<ComputeCell> &cells)
+void CellManager::copyStateToBuffer(GLuint destination, GLintptr cellOffset, GLintptr adhesionOffset) const
 {
-    // This function updates the CPU cell storage to match restored GPU data
-    cpuCells.clear();
-    cpuCells.reserve(cells.size());
-    
-    for (const auto& cell : cells) {
-        cpuCells.push_back(cell);
+    // Make sure the last simulation step has finished writing before copying
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+
+    if (cellCount > 0) {
+        glCopyNamedBufferSubData(getCellReadBuffer(), destination, 0, cellOffset, cellCount * sizeof(ComputeCell));
     }
-    
-    cellCount = static_cast<int>(cells.size());
+    if (adhesionCount > 0) {
+        glCopyNamedBufferSubData(adhesionConnectionBuffer, destination, 0, adhesionOffset, adhesionCount * sizeof(AdhesionConnection));
+    }
+}
+
+bool CellManager::restoreStateFromBuffers(GLuint cellSource, GLintptr cellOffset, int cells, GLuint adhesionSource, GLintptr adhesionOffset, int adhesions)
+{
+    // Same as restoreCellsDirectlyToGPUBuffer + restoreAdhesionConnections, but the data is already on the GPU
+    int adhesionCells = (adhesions + config::ADHESIONS_PER_CELL - 1) / config::ADHESIONS_PER_CELL;
+    if (cells > cellLimit || !reserveCellCapacity(std::max(cells, adhesionCells))) {
+        std::cout << "Warning: Restoration cell count exceeds limit!\n";
+        return false;
+    }
+
+    TimerGPU gpuTimer("Restoring Cells From Keyframe Arena");
+
+    for (int i = 0; i < 3; i++) { // Update all 3 buffers for proper rotation
+        if (cells > 0) {
+            glCopyNamedBufferSubData(cellSource, cellBuffer[i], cellOffset, 0, cells * sizeof(ComputeCell));
+        }
+    }
+    if (adhesions > 0) {
+        glCopyNamedBufferSubData(adhesionSource, adhesionConnectionBuffer, adhesionOffset, 0, adhesions * sizeof(AdhesionConnection));
+    }
+
+    // CPU-side state
+    cellCount = cells;
+    liveCellCount = cells;
+    adhesionCount = adhesions;
+    pendingCellCount = 0;
+
+    setGPUCounts({ static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(cellCount), 0u });
+
+    // Cells staged before the restore are dropped
+    cellUploadRing.discardBatch();
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    return true;
+}
+
+void CellManager::copyStateFrom(CellManager &source)
+{
+    // Make sure the source's last simulation step has finished writing before copying
+    source.addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    source.flushBarriers();
+    source.updateCounts(true); // Its regular counts can be a few ticks old
+
+    restoreStateFromBuffers(source.getCellReadBuffer(), 0, source.cellCount,
+                            source.adhesionConnectionBuffer, 0, source.adhesionCount);
+
+    GLsizeiptr reachedModesSize = std::min((modeCapacity + 31) / 32, (source.modeCapacity + 31) / 32) * sizeof(GLuint);
+    glCopyNamedBufferSubData(source.reachedModesBuffer, reachedModesBuffer, 0, 0, reachedModesSize);
+}
+
+void CellManager::uploadPlaybackCells(const std::vector<ComputeCell> &cells)
+{
+    int newCellCount = std::min(static_cast<int>(cells.size()), cellLimit);
+    reserveCellCapacity(newCellCount);
+    newCellCount = std::min(newCellCount, cellCapacity);
+
+    // Only the read buffer is drawn, so one upload per played frame is enough
+    if (newCellCount > 0) {
+        glNamedBufferSubData(getCellReadBuffer(), 0, newCellCount * sizeof(ComputeCell), cells.data());
+    }
+
+    cellCount = newCellCount;
+    liveCellCount = newCellCount;
+    adhesionCount = 0; // Connections aren't recorded; don't draw stale ones
     pendingCellCount = 0;
+
+    setGPUCounts({ static_cast<GLuint>(cellCount), 0u, static_cast<GLuint>(cellCount), 0u });
+
+    addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+std::vector<uint32_t> CellManager::getReachedModes(int modeCount) const
+{
+    std::vector<uint32_t> reachedModes((modeCount + 31) / 32, 0u);
+    int available = std::min(static_cast<int>(reachedModes.size()), (modeCapacity + 31) / 32);
+    if (available <= 0) {
+        return reachedModes;
+    }
+
+    addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+    readbackPool.read(reachedModesBuffer, 0, available * sizeof(uint32_t), reachedModes.data());
+    return reachedModes;
+}
+
+void CellManager::setReachedModes(const std::vector<uint32_t> &reachedModes)
+{
+    glClearNamedBufferData(reachedModesBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    int count = std::min(static_cast<int>(reachedModes.size()), (modeCapacity + 31) / 32);
+    if (count > 0) {
+        glNamedBufferSubData(reachedModesBuffer, 0, count * sizeof(uint32_t), reachedModes.data());
+    }
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
 }
 
 // ============================================================================
@@ -449,69 +704,158 @@ glm::vec3 pitchYawToVec3(float pitch, float yaw) {
 // GENOME & MODE MANAGEMENT
 // ============================================================================
 
-void CellManager::addGenomeToBuffer(GenomeData& genomeData) const {
-    int genomeBaseOffset = 0; // Later make it add to the end of the buffer
-    int modeCount = static_cast<int>(genomeData.modes.size());
+GPUMode toGPUMode(const ModeSettings& mode, int genomeOffset) {
+    GPUMode gmode{};
+    gmode.color = glm::vec4(mode.color, 0.0);
+    gmode.splitInterval = mode.splitInterval;
+    gmode.genomeOffset = genomeOffset;
 
-    std::vector<GPUMode> gpuModes;
-    gpuModes.reserve(modeCount);
+    // Convert from pitch and yaw to padded vec4
+    gmode.splitDirection = glm::vec4(pitchYawToVec3(
+        glm::radians(mode.parentSplitDirection.x), glm::radians(mode.parentSplitDirection.y)), 0.);
 
-    for (size_t i = 0; i < modeCount; ++i) {
-        const ModeSettings& mode = genomeData.modes[i];
+    // Store child mode indices
+    gmode.childModes = glm::ivec2(mode.childA.modeNumber, mode.childB.modeNumber);
 
-        GPUMode gmode{};
-        gmode.color = glm::vec4(mode.color, 0.0);
-        gmode.splitInterval = mode.splitInterval;
-        gmode.genomeOffset = genomeBaseOffset;
+    // Directly store quaternions (no conversion)
+    gmode.orientationA = mode.childA.orientation;  // now a quat already
+    gmode.orientationB = mode.childB.orientation;
+    
+    // Store adhesionSettings flag
+    gmode.parentMakeAdhesion = mode.parentMakeAdhesion;
 
-        // Convert from pitch and yaw to padded vec4
-        gmode.splitDirection = glm::vec4(pitchYawToVec3(
-            glm::radians(mode.parentSplitDirection.x), glm::radians(mode.parentSplitDirection.y)), 0.);
+    // Store adhesionSettings settings
+    gmode.adhesionSettings = mode.adhesionSettings;
 
-        // Store child mode indices
-        gmode.childModes = glm::ivec2(mode.childA.modeNumber, mode.childB.modeNumber);
+    return gmode;
+}
 
-        // Directly store quaternions (no conversion)
-        gmode.orientationA = mode.childA.orientation;  // now a quat already
-        gmode.orientationB = mode.childB.orientation;
-        
-        // Store adhesionSettings flag
-        gmode.parentMakeAdhesion = mode.parentMakeAdhesion;
+void CellManager::addGenomeToBuffer(const GenomeData& genomeData) {
+    // Genome 0 is the scene's own genome; replacing it keeps its offset so existing cells stay valid
+    if (genomeTable.empty()) {
+        addGenome(genomeData);
+    }
+    else if (genomeTable.replace(0, genomeData)) {
+        uploadGenome(0);
+    }
+}
 
-        // Store adhesionSettings settings
-        gmode.adhesionSettings = mode.adhesionSettings;
+int CellManager::addGenome(const GenomeData& genomeData)
+{
+    int genomeId = genomeTable.append(genomeData);
+    if (!uploadGenome(genomeId)) {
+        genomeTable.removeLast(); // No mode slots for it, cells must not refer to it
+        return -1;
+    }
+    return genomeId;
+}
 
-        gpuModes.push_back(gmode);
+bool CellManager::uploadGenome(int genomeId)
+{
+    if (!ensureModeCapacity(genomeTable.getModeCount())) {
+        return false;
     }
 
+    std::vector<GPUMode> gpuModes = genomeTable.buildGPUModes(genomeId);
     glNamedBufferSubData(
         modeBuffer,
-        genomeBaseOffset,
-        modeCount * sizeof(GPUMode),
+        genomeTable.getModeOffset(genomeId) * sizeof(GPUMode),
+        gpuModes.size() * sizeof(GPUMode),
         gpuModes.data()
     );
+    return true;
+}
+
+bool CellManager::ensureModeCapacity(int modeCount)
+{
+    if (modeBuffer != 0 && modeCount <= modeCapacity) {
+        return true;
+    }
+
+    // Grow geometrically so adding genomes one at a time doesn't reallocate every time
+    int newCapacity = std::max({ modeCount, modeCapacity * 2, config::INITIAL_MODE_CAPACITY });
+
+    GLuint newModeBuffer = bufferArena.createBuffer(GPUSubsystem::Modes,
+        newCapacity * sizeof(GPUMode),
+        GL_DYNAMIC_STORAGE_BIT  // Written by the CPU when genomes change, read frequently by GPU compute shaders
+    );
+
+    // One bit per mode slot, set by the shaders whenever a cell enters that mode
+    GLuint newReachedModesBuffer = bufferArena.createBuffer(GPUSubsystem::Modes,
+        ((newCapacity + 31) / 32) * sizeof(GLuint),
+        GL_DYNAMIC_STORAGE_BIT
+    );
+
+    // Refused by the budget or the driver: the genome table stays as it was
+    if (newModeBuffer == 0 || newReachedModesBuffer == 0) {
+        bufferArena.destroyBuffer(newModeBuffer);
+        bufferArena.destroyBuffer(newReachedModesBuffer);
+        std::cout << "Warning: not enough GPU memory for " << newCapacity << " genome modes, staying at " << modeCapacity << "\n";
+        return false;
+    }
+    glClearNamedBufferData(newReachedModesBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Existing modes and reached bits move over on the GPU
+    if (modeBuffer != 0) {
+        glCopyNamedBufferSubData(modeBuffer, newModeBuffer, 0, 0, modeCapacity * sizeof(GPUMode));
+        glCopyNamedBufferSubData(reachedModesBuffer, newReachedModesBuffer, 0, 0, ((modeCapacity + 31) / 32) * sizeof(GLuint));
+        bufferArena.destroyBuffer(modeBuffer);
+        bufferArena.destroyBuffer(reachedModesBuffer);
+    }
+
+    modeBuffer = newModeBuffer;
+    reachedModesBuffer = newReachedModesBuffer;
+    modeCapacity = newCapacity;
+    return true;
+}
+
+void CellManager::configureEnsemble(int simulations, int cellsPerSimulation, int latticeSide)
+{
+    simulationCount = std::max(simulations, 1);
+    simulationCellLimit = std::max(cellsPerSimulation, 0);
+    ensembleLatticeSide = std::clamp(latticeSide, 0, config::GRID_RESOLUTION);
+
+    bufferArena.destroyBuffer(simulationCellCountBuffer);
+    simulationCellCountBuffer = bufferArena.createBuffer(GPUSubsystem::Cells, simulationCount * sizeof(GLuint), GL_DYNAMIC_STORAGE_BIT);
+    glClearNamedBufferData(simulationCellCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+void CellManager::setSimulationCellCounts(const std::vector<uint32_t> &counts)
+{
+    int count = std::min(static_cast<int>(counts.size()), simulationCount);
+    if (count > 0) {
+        glNamedBufferSubData(simulationCellCountBuffer, 0, count * sizeof(GLuint), counts.data());
+    }
+}
+
+std::vector<uint32_t> CellManager::getSimulationCellCounts() const
+{
+    std::vector<uint32_t> counts(simulationCount, 0u);
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+    readbackPool.read(simulationCellCountBuffer, 0, counts.size() * sizeof(GLuint), counts.data());
+    return counts;
 }
 
 // ============================================================================
 // CELL DATA ACCESS & MODIFICATION
 // ============================================================================
 
-ComputeCell CellManager::getCellData(int index) const
+ComputeCell CellManager::getCellData(int index)
 {
-    if (index >= 0 && index < cellCount && index < static_cast<int>(cpuCells.size()))
+    std::vector<ComputeCell> cells = readCells(index, 1);
+    if (cells.empty())
     {
-        return cpuCells[index];
+        ComputeCell emptyCell{};
+        return emptyCell; // Return empty cell if index is invalid
     }
-    ComputeCell emptyCell{};
-    return emptyCell; // Return empty cell if index is invalid
+    return cells[0];
 }
 
 void CellManager::updateCellData(int index, const ComputeCell &newData)
 {
     if (index >= 0 && index < cellCount)
     {
-        cpuCells[index] = newData;
-
         // Update selected cell cache if this is the selected cell
         if (selectedCell.isValid && selectedCell.cellIndex == index)
         {
@@ -524,11 +868,34 @@ void CellManager::updateCellData(int index, const ComputeCell &newData)
             glNamedBufferSubData(cellBuffer[i],
                                  index * sizeof(ComputeCell),
                                  sizeof(ComputeCell),
-                                 &cpuCells[index]);
+                                 &newData);
         }
     }
 }
 
+std::vector<ComputeCell> CellManager::readCells(int first, int count, uint32_t fields)
+{
+    CellReadbackResult result;
+    if (requestCells(first, count, fields, [&result](const CellReadbackResult& landed) { result = landed; }))
+    {
+        // Requests complete in order, so this one is done once everything queued before it is
+        cellReadback.poll(readbackPool, true);
+    }
+    return std::move(result.cells);
+}
+
+bool CellManager::requestCells(int first, int count, uint32_t fields, CellReadback::Callback callback)
+{
+    count = std::min(count, cellCount - first);
+    if (first < 0 || count <= 0)
+        return false;
+
+    // The copy has to see everything the simulation has written so far
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    flushBarriers();
+    return cellReadback.request(readbackPool, getCellReadBuffer(), first, count, fields, std::move(callback));
+}
+
 // ============================================================================
 // CELL UPDATE & SIMULATION
 // ============================================================================
@@ -538,6 +905,11 @@ void CellManager::updateCells(float deltaTime)
     // Clear any pending barriers from previous frame
     clearBarriers();
 
+    cellReadback.poll(readbackPool);
+
+    // Upload grid, timestep and limits once for every compute pass of this step
+    updateSimulationConstants(deltaTime);
+
     if (pendingCellCount > 0)
     {
         addStagedCellsToQueueBuffer(); // Sync any pending cells to GPU
@@ -545,6 +917,17 @@ void CellManager::updateCells(float deltaTime)
 
     int previousCellCount = cellCount;
     updateCounts();
+
+    // Every cell may split this step and the count read back can be a few frames old, so keep headroom.
+    // If a step still runs out, the split shader just postpones the extra splits until the buffers have grown.
+    // Headroom is speculative: it stops short of any size the budget or the driver already refused.
+    int headroomCapacity = std::min(cellLimit, cellCount * config::CELL_CAPACITY_HEADROOM);
+    if (refusedCapacity > 0) {
+        headroomCapacity = std::min(headroomCapacity, refusedCapacity - 1);
+    }
+    if (headroomCapacity > cellCapacity && reserveCellCapacity(headroomCapacity)) {
+        updateSimulationConstants(deltaTime); // u_maxCells follows the capacity
+    }
     
     // Invalidate cache if cell count changed (affects legacy calculation)
     if (previousCellCount != cellCount) {
@@ -563,28 +946,31 @@ void CellManager::updateCells(float deltaTime)
         addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
         // Run physics computation on GPU (reads from previous, writes to current)
-        runPhysicsCompute(deltaTime);
+        runPhysicsCompute();
 
         addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
         // Run position/velocity update on GPU (still working on current buffer)
-        runUpdateCompute(deltaTime);
+        runUpdateCompute();
 
         addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
         // Run cells' internal calculations (this creates new pending cells from mitosis)
-        runInternalUpdateCompute(deltaTime);
+        runInternalUpdateCompute();
         
         // Single barrier after all simulation compute operations
         addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     }
 }
 
-void CellManager::renderCells(glm::vec2 resolution, Shader &cellShader, Camera &camera, bool wireframe)
+void CellManager::renderCells(glm::vec2 resolution, Shader &cellShader, bool wireframe)
 {
+    // Readbacks requested while the simulation is paused still get delivered
+    cellReadback.poll(readbackPool);
+
     // Use unified culling system if any culling is enabled
     if (useFrustumCulling || useDistanceCulling || useLODSystem) {
-        renderCellsUnified(resolution, camera, wireframe);
+        renderCellsUnified(resolution, wireframe);
         return;
     }
     
@@ -604,18 +990,10 @@ void CellManager::renderCells(glm::vec2 resolution, Shader &cellShader, Camera &
     }
     try
     {
-        // Calculate aspect ratio for frustum culling
-        float aspectRatio = resolution.x / resolution.y;
-        if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio))
-        {
-            aspectRatio = 16.0f / 9.0f;
-        }
-        
         // Use unified culling if enabled, otherwise fall back to regular extraction
         if (useFrustumCulling || useDistanceCulling || useLODSystem) {
-            // Update frustum and perform unified culling
-            	updateFrustum(camera, config::defaultFrustumFov, aspectRatio, config::defaultFrustumNearPlane, config::defaultFrustumFarPlane);
-            runUnifiedCulling(camera);
+            // Perform unified culling (frustum was updated with the frame constants)
+            runUnifiedCulling();
             
             // Setup sphere mesh to use the unified output buffer
             sphereMesh.setupInstanceBuffer(unifiedOutputBuffers[0]);
@@ -646,32 +1024,10 @@ void CellManager::renderCells(glm::vec2 resolution, Shader &cellShader, Camera &
         flushBarriers();
 
         // Use the sphere shader
-        cellShader.use();         // Set up camera matrices (only calculate once per frame, not per cell)
-        glm::mat4 view = camera.getViewMatrix();
-
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f),
-                                                aspectRatio,
-                                                0.1f, 1000.0f);
-        // Set uniforms
-        cellShader.setMat4("uProjection", projection);
-        cellShader.setMat4("uView", view);
-        cellShader.setVec3("uCameraPos", camera.getPosition());
-        // Set fixed world-space directional light (like sunlight)
-        cellShader.setVec3("uLightDir", glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f)));
-        // Set selection highlighting uniforms
-        if (selectedCell.isValid)
-        {
-            glm::vec3 selectedPos = glm::vec3(selectedCell.cellData.positionAndMass);
-            float selectedRadius = selectedCell.cellData.getRadius();
-            cellShader.setVec3("uSelectedCellPos", selectedPos);
-            cellShader.setFloat("uSelectedCellRadius", selectedRadius);
-        }
-        else
-        {
-            cellShader.setVec3("uSelectedCellPos", glm::vec3(-9999.0f)); // Invalid position
-            cellShader.setFloat("uSelectedCellRadius", 0.0f);
-        }
-        cellShader.setFloat("uTime", static_cast<float>(glfwGetTime())); // Enable depth testing for proper 3D rendering (don't clear here - already done in main loop)
+        // Camera matrices, lighting and selection highlighting come from the FrameConstants block
+        cellShader.use();
+
+        // Enable depth testing for proper 3D rendering (don't clear here - already done in main loop)
         glEnable(GL_DEPTH_TEST);
         
         // Enable back face culling for better performance
@@ -708,34 +1064,25 @@ void CellManager::renderCells(glm::vec2 resolution, Shader &cellShader, Camera &
     }
 }
 
-void CellManager::runPhysicsCompute(float deltaTime)
+void CellManager::runPhysicsCompute()
 {
     TimerGPU timer("Cell Physics Compute");
 
     physicsShader->use();
 
-    // Set uniforms
-
-    // Pass dragged cell index to skip its physics
-    int draggedIndex = (isDraggingCell && selectedCell.isValid) ? selectedCell.cellIndex : -1;
-    physicsShader->setInt("u_draggedCellIndex", draggedIndex);
-
-    // Set spatial grid uniforms
-    physicsShader->setInt("u_gridResolution", config::GRID_RESOLUTION);
-    physicsShader->setFloat("u_gridCellSize", config::GRID_CELL_SIZE);
-    physicsShader->setFloat("u_worldSize", config::WORLD_SIZE);
-    physicsShader->setInt("u_maxCellsPerGrid", config::MAX_CELLS_PER_GRID); // Bind buffers (read from previous buffer, write to current buffer for stable simulation)
+    // Grid settings and the dragged cell index come from the SimulationConstants block
+    // Bind buffers (read from previous buffer, write to current buffer for stable simulation)
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer()); // Read from previous frame
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gridBuffer);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gridCountBuffer);
+    gridBuffer.bindStorage(1);
+    gridCountBuffer.bindStorage(2);
 
     // Also bind current buffer as output for physics results
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, getCellWriteBuffer()); // Write to current frame
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, gpuCellCountBuffer); // Bind GPU cell count buffer
 
     // Dispatch compute shader - OPTIMIZED for 256 work group size
-    GLuint numGroups = (cellCount + 255) / 256; // Changed from 64 to 256 for better GPU utilization
-    physicsShader->dispatch(numGroups, 1, 1);
+    // Sized from the GPU count by prepareStepDispatch, the CPU count can be a few ticks old
+    physicsShader->dispatchIndirect(stepDispatchBuffer);
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
@@ -747,26 +1094,21 @@ void CellManager::runPhysicsCompute(float deltaTime)
 // COMPUTE SHADER DISPATCH
 // ============================================================================
 
-void CellManager::runUpdateCompute(float deltaTime)
+void CellManager::runUpdateCompute()
 {
     TimerGPU timer("Cell Update Compute");
 
 	updateShader->use();
 
-    // Set uniforms
-    updateShader->setFloat("u_deltaTime", deltaTime);
-    updateShader->setFloat("u_damping", 0.98f);
-
-    // Pass dragged cell index to skip its position updates
-    int draggedIndex = (isDraggingCell && selectedCell.isValid) ? selectedCell.cellIndex : -1;
-    updateShader->setInt("u_draggedCellIndex", draggedIndex); // Bind current cell buffer for in-place updates
+    // Timestep, damping and the dragged cell index come from the SimulationConstants block
+    // Bind current cell buffer for in-place updates
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, getCellWriteBuffer());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gpuCellCountBuffer); // Bind GPU cell count buffer
 
     // Dispatch compute shader - OPTIMIZED for 256 work group size
-    GLuint numGroups = (cellCount + 255) / 256; // Changed from 64 to 256 for better GPU utilization
-    updateShader->dispatch(numGroups, 1, 1);
+    // Sized from the GPU count by prepareStepDispatch, the CPU count can be a few ticks old
+    updateShader->dispatchIndirect(stepDispatchBuffer);
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
@@ -774,26 +1116,25 @@ void CellManager::runUpdateCompute(float deltaTime)
     rotateBuffers();
 }
 
-void CellManager::runInternalUpdateCompute(float deltaTime)
+void CellManager::runInternalUpdateCompute()
 {
     TimerGPU timer("Cell Internal Update Compute");
 
     internalUpdateShader->use();
 
-    // Set uniforms
-    internalUpdateShader->setFloat("u_deltaTime", deltaTime);
-    internalUpdateShader->setInt("u_maxCells", cellLimit);
-    internalUpdateShader->setInt("u_maxAdhesions", cellLimit*12);
+    // Timestep and buffer limits come from the SimulationConstants block
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, modeBuffer);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, getCellReadBuffer());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, getCellWriteBuffer());
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, cellAdditionBuffer);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, gpuCellCountBuffer);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, adhesionConnectionBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, reachedModesBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, simulationCellCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, stepDispatchBuffer); // Bounds the pass to the cells the step started with
 
     // Dispatch compute shader - OPTIMIZED for 256 work group size
-    GLuint numGroups = (cellCount + 255) / 256; // Changed from 64 to 256 for better GPU utilization
-    internalUpdateShader->dispatch(numGroups, 1, 1);
+    // Sized from the GPU count by prepareStepDispatch, the CPU count can be a few ticks old
+    internalUpdateShader->dispatchIndirect(stepDispatchBuffer);
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
@@ -801,20 +1142,36 @@ void CellManager::runInternalUpdateCompute(float deltaTime)
     rotateBuffers();
 }
 
+void CellManager::prepareStepDispatch()
+{
+    stepDispatchShader->use();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gpuCellCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, stepDispatchBuffer);
+    stepDispatchShader->dispatch(1, 1, 1);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // The arguments are read both as dispatch parameters and by the internal update pass
+    addBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    flushBarriers();
+}
+
 void CellManager::applyCellAdditions()
 {
     TimerGPU timer("Cell Additions");
 
     cellAdditionShader->use();
+    bindSimulationConstants(); // May run outside updateCells (e.g. when spawning)
 
     // Set uniforms
-    cellAdditionShader->setInt("u_maxCells", cellLimit);
     cellAdditionShader->setInt("u_pendingCellCount", pendingCellCount);
 
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellAdditionBuffer);
+    cellUploadRing.getBatch().bindStorage(0);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, getCellReadBuffer());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, getCellWriteBuffer());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gpuCellCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, reachedModesBuffer);
 
     // Dispatch compute shader
     GLuint numGroups = (pendingCellCount + 63) / 64;
@@ -833,26 +1190,25 @@ void CellManager::applyCellAdditions()
 void CellManager::resetSimulation()
 {
     // Clear CPU-side data
-    cpuCells.clear();
-    cellStagingBuffer.clear();
+    cellUploadRing.discardBatch();
+    if (cellUploadRing.getCapacity() > config::CELL_UPLOAD_RING_INITIAL_CELLS) {
+        cellUploadRing.release(bufferArena); // A ring grown for a large spawn goes back to its initial size
+    }
     cellCount = 0;
     pendingCellCount = 0;
     adhesionCount = 0;
     
     // CRITICAL FIX: Reset buffer rotation state for consistent keyframe restoration
     bufferRotation = 0;
+
+    // Give back the memory of a large population (the buffers are cleared below either way)
+    resizeCellBuffers(std::max(1, std::min(cellLimit, config::INITIAL_CELL_CAPACITY)));
     
     // Clear selection state
     clearSelection();
     
-    // Clear GPU buffers by setting them to zero
-    GLuint zero = 0;
-    
     // Reset cell count buffers
-    glNamedBufferSubData(gpuCellCountBuffer, 0, sizeof(GLuint), &zero); // cellCount = 0
-    glNamedBufferSubData(gpuCellCountBuffer, sizeof(GLuint), sizeof(GLuint), &zero); // adhesionCount = 0
-    glNamedBufferSubData(gpuCellCountBuffer, 2 * sizeof(GLuint), sizeof(GLuint), &zero); // liveCellCount = 0
-    glNamedBufferSubData(gpuCellCountBuffer, 3 * sizeof(GLuint), sizeof(GLuint), &zero); // liveAdhesionCount = 0
+    setGPUCounts(CellCounts{});
     
     // Clear all cell buffers
     for (int i = 0; i < 3; i++)
@@ -866,52 +1222,36 @@ void CellManager::resetSimulation()
         glClearNamedBufferData(instanceBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
     }
     
-    // Clear addition buffer
-    if (cellAdditionBuffer != 0) {
-        glClearNamedBufferData(cellAdditionBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    
     // Clear spatial grid buffers
-    if (gridBuffer != 0) {
-        glClearNamedBufferData(gridBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    if (gridCountBuffer != 0) {
-        glClearNamedBufferData(gridCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    if (gridOffsetBuffer != 0) {
-        glClearNamedBufferData(gridOffsetBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    if (gridHashBuffer != 0) {
-        glClearNamedBufferData(gridHashBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    if (activeCellsBuffer != 0) {
-        glClearNamedBufferData(activeCellsBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    for (const GPUBufferRange* range : { &gridBuffer, &gridCountBuffer, &gridOffsetBuffer, &gridHashBuffer, &activeCellsBuffer }) {
+        if (range->isValid()) {
+            range->clear();
+        }
     }
     
-    // Clear adhesionSettings line buffer to prevent lingering lines after reset
-    if (adhesionLineBuffer != 0) {
-        glClearNamedBufferData(adhesionLineBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    if (reachedModesBuffer != 0) {
+        glClearNamedBufferData(reachedModesBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
     }
     
+    // Back to a single simulation; the caller adds the genome(s) for the new state
+    simulationCount = 1;
+    simulationCellLimit = 0;
+    ensembleLatticeSide = 0;
+    genomeTable.clear();
+    
     // Clear adhesionSettings connection buffer to prevent lingering connections after reset
     if (adhesionConnectionBuffer != 0) {
         glClearNamedBufferData(adhesionConnectionBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
     }
     adhesionCount = 0;
     
-    // Clear debug visualization buffers to prevent lingering elements after reset
-    if (gizmoBuffer != 0) {
-        glClearNamedBufferData(gizmoBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    if (ringGizmoBuffer != 0) {
-        glClearNamedBufferData(ringGizmoBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-    }
-    
     // Clear LOD and frustum culling buffers
     for (int i = 0; i < 4; i++) {
         if (lodInstanceBuffers[i] != 0) {
             glClearNamedBufferData(lodInstanceBuffers[i], GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
         }
+    }
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
         lodInstanceCounts[i] = 0; // Reset CPU-side LOD counts
     }
     
@@ -921,7 +1261,7 @@ void CellManager::resetSimulation()
         glClearNamedBufferData(lodCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
     }
     // Clear unified output buffers
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
         if (unifiedOutputBuffers[i] != 0) {
             glClearNamedBufferData(unifiedOutputBuffers[i], GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
         }
@@ -936,37 +1276,57 @@ void CellManager::resetSimulation()
 // CELL SPAWNING & RESET
 // ============================================================================
 
-void CellManager::spawnCells(int count)
+void CellManager::spawnCells(int count, const SpawnDistribution& distribution, uint32_t seed)
 {
-    TimerCPU cpuTimer("Spawning Cells");
+    TimerGPU timer("Spawning Cells");
 
-    for (int i = 0; i < count && cellCount < cellLimit; ++i)
-    {
-        // Random position within spawn radius
-        float angle1 = static_cast<float>(rand()) / RAND_MAX * 2.0f * 3.14159f;
-        float angle2 = static_cast<float>(rand()) / RAND_MAX * 3.14159f;
-        float radius = static_cast<float>(rand()) / RAND_MAX * spawnRadius;
-
-        glm::vec3 position = glm::vec3(
-            radius * sin(angle2) * cos(angle1),
-            radius * cos(angle2),
-            radius * sin(angle2) * sin(angle1));
-
-        // Random velocity
-        glm::vec3 velocity = glm::vec3(
-            (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 5.0f,
-            (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 5.0f,
-            (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 5.0f); // Random mass and fixed radius of 1
-        //float mass = 1.0f + static_cast<float>(rand()) / RAND_MAX * 2.0f;
-        //float cellRadius = 1.0f; // All cells have the same radius of 1
-
-        ComputeCell newCell{};
-        newCell.positionAndMass = glm::vec4(position, 1.);
-        newCell.velocity = glm::vec4(velocity, 0.);
-        newCell.acceleration = glm::vec4(0.0f); // Reset acceleration
-
-        addCellToStagingBuffer(newCell);
-    }
+    // Room is reserved for the staged cells too, they are applied first
+    updateCounts(true);
+    count = std::min(count, cellLimit - cellCount - pendingCellCount);
+    if (count <= 0 || !reserveCellCapacity(cellCount + pendingCellCount + count))
+        return;
+
+    // Cells staged on the CPU go first so they keep their place in front of the new population
+    addStagedCellsToQueueBuffer();
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    flushBarriers();
+
+    spawnShader->use();
+    bindSimulationConstants(); // May run outside updateCells
+
+    spawnShader->setInt("u_spawnCount", count);
+    spawnShader->setInt("u_seed", static_cast<int>(seed));
+    spawnShader->setInt("u_shape", static_cast<int>(distribution.shape));
+    spawnShader->setVec3("u_center", distribution.center);
+    spawnShader->setFloat("u_radius", distribution.radius);
+    spawnShader->setFloat("u_shellThickness", distribution.shellThickness);
+    spawnShader->setInt("u_clusterCount", distribution.clusterCount);
+    spawnShader->setFloat("u_clusterSpread", distribution.clusterSpread);
+    spawnShader->setFloat("u_speed", distribution.speed);
+    spawnShader->setInt("u_modeIndex", distribution.modeIndex);
+    spawnShader->setInt("u_genomeOffset", distribution.genomeOffset);
+    spawnShader->setInt("u_commit", 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, getCellWriteBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gpuCellCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, reachedModesBuffer);
+
+    GLuint numGroups = (count + 255) / 256;
+    spawnShader->dispatch(numGroups, 1, 1);
+
+    // The count is only bumped once every invocation has read it
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    flushBarriers();
+    spawnShader->setInt("u_commit", 1);
+    spawnShader->dispatch(1, 1, 1);
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Same as applyCellAdditions, the new cells are in both buffers
+    rotateBuffers();
+    expectCellCount(cellCount + count);
 }
 
 // ============================================================================
@@ -982,13 +1342,7 @@ void CellManager::initializeStreamCompactionSystem()
     liveCellCount = cellCount;
 
     // Update GPU buffers with initial values
-    GLuint counts[4] = { 
-        static_cast<GLuint>(cellCount), 
-        static_cast<GLuint>(adhesionCount),
-        static_cast<GLuint>(liveCellCount),
-        0u // liveAdhesionCount
-    };
-    glNamedBufferSubData(gpuCellCountBuffer, 0, sizeof(GLuint) * 4, counts);
+    setGPUCounts({ static_cast<GLuint>(cellCount), static_cast<GLuint>(adhesionCount), static_cast<GLuint>(liveCellCount), 0u });
 
     std::cout << "Stream compaction system initialized\n";
 }
@@ -996,18 +1350,9 @@ void CellManager::initializeStreamCompactionSystem()
 void CellManager::cleanupStreamCompactionSystem()
 {
     // Cleanup stream compaction buffers
-    if (deadMarkersBuffer != 0) {
-        glDeleteBuffers(1, &deadMarkersBuffer);
-        deadMarkersBuffer = 0;
-    }
-    if (prefixSumBuffer != 0) {
-        glDeleteBuffers(1, &prefixSumBuffer);
-        prefixSumBuffer = 0;
-    }
-    if (deadIndicesBuffer != 0) {
-        glDeleteBuffers(1, &deadIndicesBuffer);
-        deadIndicesBuffer = 0;
-    }
+    bufferArena.destroyBuffer(deadMarkersBuffer);
+    bufferArena.destroyBuffer(prefixSumBuffer);
+    bufferArena.destroyBuffer(deadIndicesBuffer);
 
     // Cleanup compute shader
     if (streamCompactShader) {
@@ -1024,9 +1369,7 @@ void CellManager::performStreamCompaction()
     TimerGPU timer("Stream Compaction");
 
     streamCompactShader->use();
-
-    // Set uniforms
-    streamCompactShader->setInt("u_maxCells", cellLimit);
+    bindSimulationConstants();
 
     // Bind buffers
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellWriteBuffer());
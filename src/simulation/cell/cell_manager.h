@@ -9,6 +9,11 @@
 #include "../../core/config.h"
 #include "../../rendering/core/mesh/sphere_mesh.h"
 #include "../cell/common_structs.h"
+#include "genome_table.h"
+#include "../../rendering/core/gpu_buffer_arena.h"
+#include "cell_upload_ring.h"
+#include "cell_readback.h"
+#include "count_snapshot_ring.h"
 #include "../../rendering/systems/frustum_culling.h"
 
 // Forward declaration
@@ -18,12 +23,42 @@ class Camera;
 static_assert(sizeof(ComputeCell) % 16 == 0, "ComputeCell must be 16-byte aligned for GPU usage");
 static_assert(sizeof(GPUMode) % 16 == 0, "GPUMode must be 16-byte aligned for GPU usage");
 
+// Converts a genome mode to the layout the compute shaders read from the mode buffer
+GPUMode toGPUMode(const ModeSettings& mode, int genomeOffset);
+
+// How spawnCells lays out a bulk population (generated on the GPU by spawn_cells.comp)
+enum class SpawnShape
+{
+    Ball,             // Uniform inside a sphere of `radius`
+    Shell,            // Uniform between `radius - shellThickness` and `radius`
+    Lattice,          // Cubic grid filling a cube of half extent `radius`
+    GaussianClusters  // `clusterCount` normal blobs of deviation `clusterSpread`, centred inside `radius`
+};
+
+struct SpawnDistribution
+{
+    SpawnShape shape = SpawnShape::Ball;
+    glm::vec3 center{ 0.0f };
+    float radius = config::DEFAULT_SPAWN_RADIUS;
+    float shellThickness = 5.0f;
+    int clusterCount = 8;
+    float clusterSpread = 5.0f;
+    float speed = 5.0f;     // Random velocity range per axis
+    int modeIndex = 0;
+    int genomeOffset = 0;
+};
+
 struct CellManager
 {
     // GPU-based cell management using compute shaders
     // This replaces the CPU-based vectors with GPU buffer objects
     // The compute shaders handle physics calculations and position updates
 
+    // Allocates, accounts and budgets every GPU buffer below
+    GPUBufferArena bufferArena;
+    // Recycled staging buffers for every GPU -> CPU copy (cells, adhesions, counters, checkpoints)
+    mutable ReadbackPool readbackPool{ bufferArena };
+
     // GPU buffer objects - Triple buffered for performance
     GLuint cellBuffer[3]{};         // SSBO for compute cell data (double buffered)
     GLuint instanceBuffer{};        // VBO for instance rendering data
@@ -31,32 +66,47 @@ struct CellManager
 
     // Cell count management
     GLuint gpuCellCountBuffer{};     // GPU-accessible cell count buffer
-    GLuint stagingCellCountBuffer{}; // CPU-accessible cell count buffer (no sync stalls)
-    GLuint cellAdditionBuffer{};     // Cell addition queue for GPU
+    GLuint stepDispatchBuffer{};     // Indirect dispatch arguments of the per-cell passes + the count the step started with
+    CountSnapshotRing countSnapshots; // Fenced copies of gpuCellCountBuffer the CPU counts are read from
+    CellUploadRing cellUploadRing;   // Persistently mapped cell addition queue the CPU writes into
+    CellReadback cellReadback;       // Fenced cell reads for the CPU (see readCells / requestCells)
 
     // NEW: Stream compaction buffers
     GLuint deadMarkersBuffer{};      // Buffer for marking dead cells (1 = dead, 0 = alive)
     GLuint prefixSumBuffer{};        // Buffer for prefix sum calculation
     GLuint deadIndicesBuffer{};      // Buffer for sorted list of dead cell indices
 
-    // Cell data staging buffer for CPU reads (avoids GPU->CPU transfer warnings)
-    GLuint stagingCellBuffer{};      // CPU-accessible cell data buffer
-    void* mappedCellPtr = nullptr;   // Pointer to the cell data staging buffer
-
-    // Genome buffer (immutable, no need for double buffering)
-    // It might be a good idea in the future to switch from a flattened mode array to genome structs that contain their own mode arrays
+    // Genome buffer (single buffered, only written when genomes change)
+    // Flattened modes of every genome in genomeTable; cells index it with genomeOffset + modeIndex
+    GenomeTable genomeTable;
     GLuint modeBuffer{};
-
-    // Spatial partitioning buffers - Double buffered
-    GLuint gridBuffer{};       // SSBO for grid cell data (stores cell indices)
-    GLuint gridCountBuffer{};  // SSBO for grid cell counts
-    GLuint gridOffsetBuffer{}; // SSBO for grid cell starting offsets
+    GLuint reachedModesBuffer{};     // Bitfield of every mode a cell has been in since the last reset (keyframe invalidation)
+    int modeCapacity{0};             // Mode slots allocated in modeBuffer and reachedModesBuffer
+
+    // Ensemble mode: several independent simulations share these buffers (see SimulationEnsemble).
+    // Cells carry their simulationId, every simulation is confined to its own block of grid cells,
+    // physics ignores pairs from different simulations and every simulation may hold at most simulationCellLimit cells.
+    GLuint simulationCellCountBuffer{}; // Cells per simulation, incremented by the split shader
+    int simulationCount{1};
+    int simulationCellLimit{0};         // 0 = single simulation, only cellLimit applies
+    int ensembleLatticeSide{0};         // Blocks per world axis, 0 = single simulation (see SimulationEnsemble::getBlockSize)
+
+    // Spatial partitioning buffers - ranges of one arena block
+    GPUBufferRange gridBuffer;       // SSBO for grid cell data (stores cell indices)
+    GPUBufferRange gridCountBuffer;  // SSBO for grid cell counts
+    GPUBufferRange gridOffsetBuffer; // SSBO for grid cell starting offsets
     
     // PERFORMANCE OPTIMIZATION: Additional buffers for 100k cells
-    GLuint gridHashBuffer{};   // Hash-based lookup for sparse grids
-    GLuint activeCellsBuffer{}; // Buffer containing only active grid cells
+    GPUBufferRange gridHashBuffer;   // Hash-based lookup for sparse grids
+    GPUBufferRange activeCellsBuffer; // Buffer containing only active grid cells
     uint32_t activeGridCount{0}; // Number of active grid cells
 
+    // Constant uniform buffers (std140, layouts generated in common_structs.h)
+    GLuint frameConstantsUBO{};             // Camera, frustum, LOD and fade settings, selection
+    GLuint simulationConstantsUBO{};        // Grid, timestep and buffer limits
+    FrameConstants frameConstants;          // CPU copy of the last uploaded frame constants
+    SimulationConstants simulationConstants; // CPU copy of the last uploaded simulation constants
+
     // Sphere mesh for instanced rendering
     SphereMesh sphereMesh;
 
@@ -65,7 +115,9 @@ struct CellManager
     Shader* lodComputeShader = nullptr;       // Compute shader for LOD assignment
     GLuint lodInstanceBuffers[4]{};           // Instance buffers for each LOD level
     GLuint lodCountBuffer{};                  // Buffer to track instance counts per LOD level
-    int lodInstanceCounts[4]{};               // CPU-side copy of LOD instance counts
+    static constexpr int IMPOSTOR_LOD_LEVEL = SphereMesh::LOD_LEVELS; // Cells past the last mesh LOD are ray-cast impostors
+    static constexpr int UNIFIED_LOD_LEVELS = SphereMesh::LOD_LEVELS + 1; // Mesh LODs plus the impostor level
+    int lodInstanceCounts[UNIFIED_LOD_LEVELS]{}; // CPU-side copy of LOD instance counts
     float lodDistances[4] = {
         config::defaultLodDistance0,
         config::defaultLodDistance1,
@@ -79,7 +131,9 @@ struct CellManager
     // Unified culling system
     Shader* unifiedCullShader = nullptr;      // Unified compute shader for all culling modes
     Shader* distanceFadeShader = nullptr;     // Vertex/fragment shaders for distance-based fading
-    GLuint unifiedOutputBuffers[4]{};         // Output buffers for each LOD level
+    Shader* impostorShader = nullptr;         // Ray-cast sphere impostor shaders for the most distant LOD level
+    GLuint impostorVAO{};                     // Empty VAO, impostor quads are generated from gl_VertexID
+    GLuint unifiedOutputBuffers[UNIFIED_LOD_LEVELS]{}; // Output buffers for each LOD level (last one feeds the impostors)
     GLuint unifiedCountBuffer{};              // Buffer for LOD counts
     bool useFrustumCulling = config::defaultUseFrustumCulling;            // Enable/disable frustum culling
     bool useDistanceCulling = config::defaultUseDistanceCulling;          // Enable/disable distance-based culling
@@ -112,6 +166,8 @@ struct CellManager
     Shader* extractShader = nullptr; // For extracting instance data efficiently
     Shader* internalUpdateShader = nullptr;
     Shader* cellAdditionShader = nullptr;
+    Shader* spawnShader = nullptr;   // Generates bulk populations in place
+    Shader* stepDispatchShader = nullptr; // Sizes the per-cell passes from the GPU cell count
 
     // NEW: Stream compaction compute shader
     Shader* streamCompactShader = nullptr; // Compact cells using prefix sum
@@ -122,40 +178,26 @@ struct CellManager
     Shader* gridPrefixSumShader = nullptr; // Calculate grid offsets
     Shader* gridInsertShader = nullptr;    // Insert cells into grid
     
-    // CPU-side storage for initialization and debugging
-    // Note: cpuCells is deprecated in favor of GPU buffers, should be removed after refactoring
-    std::vector<ComputeCell> cpuCells;
-    std::vector<ComputeCell> cellStagingBuffer;
-    
     // Cell count tracking (CPU-side approximation of GPU state)
-    int cellCount{0};               // Approximate cell count, may not reflect exact GPU state due to being a frame behind
+    int cellCount{0};               // Cell count from the latest count snapshot, may be a few ticks behind the GPU (see updateCounts)
     int pendingCellCount{0};     // Number of cells pending addition by CPU
-    // Mysteriously the value read on cpu is always undershooting significantly so you're better off treating it as a bool than an int
     int adhesionCount{ 0 };
     // NEW: Live count tracking for efficient thread dispatch
     int liveCellCount{0};           // Number of actually live cells (excluding dead ones)
-    void* mappedPtr = nullptr;      // Pointer to the cell count staging buffer
-    GLuint* countPtr = nullptr;     // Typed pointer to the mapped buffer value
-    void syncCounterBuffers()
-    {
-        glCopyNamedBufferSubData(gpuCellCountBuffer, stagingCellCountBuffer, 0, 0, sizeof(GLuint) * 4);
-    }
-    void updateCounts()
-    {
-        syncCounterBuffers();
-
-        // Add buffer update barrier but don't flush yet
-        addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-
-        cellCount = countPtr[0];
-        adhesionCount = countPtr[1]; // This is the number of adhesionSettings connections, not cells
-        liveCellCount = countPtr[2]; // NEW: Read live cell count
-    }
+    // Snapshots the GPU counters and takes the newest one that has landed, never waits.
+    // With `exact` set it waits for the GPU instead, for sizing decisions that can't work with an old count.
+    void updateCounts(bool exact = false);
+    // Overwrites the GPU counters from the CPU, older snapshots are dropped
+    void setGPUCounts(const CellCounts& counts);
+    // Takes the cell count a pass is known to leave behind without waiting for it to be read back
+    void expectCellCount(int count);
 
     // Configuration
     static constexpr int DEFAULT_CELL_COUNT = config::DEFAULT_CELL_COUNT;
     float spawnRadius = config::DEFAULT_SPAWN_RADIUS;
     int cellLimit = config::MAX_CELLS;
+    int cellCapacity = 0;           // Cells the per-cell buffers are currently allocated for (<= cellLimit, grows on demand)
+    int refusedCapacity = 0;        // Smallest capacity a resize failed for, 0 if none; speculative growth stays below it
 
     // Constructor and destructor
     CellManager();
@@ -166,28 +208,31 @@ struct CellManager
     // So we will define the functions in a separate file to avoid recompiling the whole project when we change the implementation.
 
     void initializeGPUBuffers();
+    void initializeConstantBuffers();
+    void cleanupConstantBuffers();
+    // Uploads and binds the frame constants, call once per frame before any render function
+    void updateFrameConstants(glm::vec2 resolution, const class Camera &camera);
+    // Uploads and binds the simulation constants for this manager's compute passes
+    void updateSimulationConstants(float deltaTime);
+    void bindSimulationConstants() const;
     void resetSimulation();
-    void spawnCells(int count = DEFAULT_CELL_COUNT);
-    void renderCells(glm::vec2 resolution, Shader &cellShader, class Camera &camera, bool wireframe = false);
+    // Creates `count` cells directly in the cell buffers, the same seed always gives the same population
+    void spawnCells(int count = DEFAULT_CELL_COUNT, const SpawnDistribution& distribution = {}, uint32_t seed = 1);
+    void renderCells(glm::vec2 resolution, Shader &cellShader, bool wireframe = false);
     // Gizmo orientation visualization
-    GLuint gizmoBuffer{};           // Buffer for gizmo line vertices
-    GLuint gizmoVAO{};              // VAO for gizmo rendering
-    GLuint gizmoVBO{};              // VBO for gizmo vertices
-    Shader* gizmoExtractShader = nullptr; // Compute shader for generating gizmo data
+    // Debug geometry is generated in the vertex shaders from the cell/connection SSBOs (vertex pulling),
+    // so the VAOs below have no attributes; core profile just needs one bound to draw.
+    GLuint gizmoVAO{};              // Empty VAO for gizmo rendering
     Shader* gizmoShader = nullptr;        // Vertex/fragment shaders for rendering gizmos
     
     // Ring gizmo visualization
-    GLuint ringGizmoBuffer{};           // Buffer for ring gizmo vertices
-    GLuint ringGizmoVAO{};              // VAO for ring gizmo rendering
-    GLuint ringGizmoVBO{};              // VBO for ring gizmo vertices
-    Shader* ringGizmoExtractShader = nullptr; // Compute shader for generating ring gizmo data
+    static constexpr int RING_GIZMO_TEMPLATE_VERTICES = 384; // 2 rings * 32 segments * 6 vertices
+    GLuint ringGizmoVAO{};              // VAO for the instanced ring template
+    GLuint ringGizmoTemplateVBO{};      // Shared ring template vertices (instanced per drawn cell)
     Shader* ringGizmoShader = nullptr;        // Vertex/fragment shaders for rendering ring gizmos
     
     // Adhesion line visualization
-    GLuint adhesionLineBuffer{};        // Buffer for adhesionSettings line vertices  
-    GLuint adhesionLineVAO{};           // VAO for adhesionSettings line rendering
-    GLuint adhesionLineVBO{};           // VBO for adhesionSettings line vertices
-    Shader* adhesionLineExtractShader = nullptr; // Generate adhesionSettings line data
+    GLuint adhesionLineVAO{};           // Empty VAO for adhesionSettings line rendering
     Shader* adhesionLineShader = nullptr;        // Vertex/fragment shaders for rendering adhesionSettings lines
 
     // Adhesion connection system
@@ -195,20 +240,17 @@ struct CellManager
     Shader* adhesionPhysicsShader = nullptr;  // Compute shader for processing adhesionSettings physics
 
     void initializeGizmoBuffers();
-    void updateGizmoData();
     void cleanupGizmos();
-    void renderGizmos(glm::vec2 resolution, const Camera& camera, bool showGizmos);
+    void renderGizmos(bool showGizmos);
     
     // Ring gizmo methods
-    void renderRingGizmos(glm::vec2 resolution, const class Camera &camera, const class UIManager &uiManager);
+    void renderRingGizmos(const class UIManager &uiManager);
     void initializeRingGizmoBuffers();
-    void updateRingGizmoData();
     void cleanupRingGizmos();
     
     // Adhesion line methods
-    void renderAdhesionLines(glm::vec2 resolution, const class Camera &camera, bool showAdhesionLines);
+    void renderAdhesionLines(bool showAdhesionLines);
     void initializeAdhesionLineBuffers();
-    void updateAdhesionLineData();
     void cleanupAdhesionLines();
 
     void initializeAdhesionConnectionSystem();
@@ -218,10 +260,16 @@ struct CellManager
     // CELL ADDITION RULES:
 	// Add cells to the staging buffer, which is then processed by the GPU automatically every frame.
 	// Do not add cells directly to the GPU buffer, as they may not be processed immediately, and may be overwritten. Use the staging buffer instead.
-    void addCellsToQueueBuffer(const std::vector<ComputeCell> &cells);
     void addCellToStagingBuffer(const ComputeCell &newCell);
+    void addCellsToStagingBuffer(const ComputeCell *cells, int count); // Bulk version, one pass into the upload ring
     void addStagedCellsToQueueBuffer();
-    void addGenomeToBuffer(GenomeData& genomeData) const;
+    void addGenomeToBuffer(const GenomeData& genomeData); // Sets the scene's own genome (genome 0 of the table)
+    int addGenome(const GenomeData& genomeData);          // Appends another genome; cells using it need genomeTable.getModeOffset(id) as genomeOffset. -1 if out of GPU memory
+    bool uploadGenome(int genomeId);
+    bool ensureModeCapacity(int modeCount);               // False (old buffers kept) if the larger buffers can't be allocated
+    void configureEnsemble(int simulations, int cellsPerSimulation, int latticeSide); // Call after resetSimulation, before adding cells
+    void setSimulationCellCounts(const std::vector<uint32_t> &counts);
+    std::vector<uint32_t> getSimulationCellCounts() const; // Small synchronous readback, one counter per simulation
     void updateCells(float deltaTime);
     void cleanup();
 
@@ -257,16 +305,13 @@ struct CellManager
     void handleMouseInput(const glm::vec2 &mousePos, const glm::vec2 &screenSize,
                           const class Camera &camera, bool isMousePressed, bool isMouseDown,
                           float scrollDelta = 0.0f);
-    int selectCellAtPosition(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection);
+    int selectCellAtPosition(const std::vector<ComputeCell> &cells, const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection);
     void dragSelectedCell(const glm::vec3 &newWorldPosition);
     void clearSelection();
 
     // Handle the end of dragging (restore physics)
     void endDrag();
 
-    // GPU synchronization for selection (synchronous readback for immediate use)
-    void syncCellPositionsFromGPU();
-
     // Utility functions for mouse interaction
     glm::vec3 calculateMouseRay(const glm::vec2 &mousePos, const glm::vec2 &screenSize,
                                 const class Camera &camera);
@@ -276,8 +321,14 @@ struct CellManager
     // Getters for selection system
     bool hasSelectedCell() const { return selectedCell.isValid; }
     const SelectedCellInfo &getSelectedCell() const { return selectedCell; }
-    ComputeCell getCellData(int index) const;
-    void updateCellData(int index, const ComputeCell &newData); // Needs refactoring
+    ComputeCell getCellData(int index); // Blocking single-cell readback
+    void updateCellData(int index, const ComputeCell &newData);
+
+    // Cell readback: only the requested range and fields are copied off the GPU
+    // Blocks until the copy has landed, the result holds at most cellCount - first cells
+    std::vector<ComputeCell> readCells(int first, int count, uint32_t fields = CELL_FIELD_ALL);
+    // Returns immediately, the callback runs from a later updateCells or renderCells once the copy is done
+    bool requestCells(int first, int count, uint32_t fields, CellReadback::Callback callback);
 
     // Memory barrier optimization system
     // Forward declaration and performance monitoring
@@ -380,22 +431,28 @@ struct CellManager
 	//     2 |  R |  S |  W
 	//     3 |  S |  W |  R
 
-    void setCellLimit(int limit) { cellLimit = limit; }
+    void setCellLimit(int limit); // Also shrinks the buffers if they are larger than the new limit
     int getCellLimit() const { return cellLimit; }
+    int getCellCapacity() const { return cellCapacity; }
+    bool reserveCellCapacity(int cells); // Grows the per-cell buffers to hold at least `cells`; false if over the limit or out of memory
+    size_t getBytesPerCell(); // GPU memory one cell of capacity costs across all per-cell buffers
+    size_t estimateGPUBytes(int cells); // GPU memory this manager would hold with its per-cell buffers sized for `cells`
+    bool fitsCellsAfterReset(int cells); // True if, after resetSimulation, the per-cell buffers could grow to `cells` within the limit and budget
     
     // LOD system functions
     void initializeLODSystem();
     void cleanupLODSystem();
-    void updateLODLevels(const Camera& camera);
+    void updateLODLevels();
     void renderCellsLOD(glm::vec2 resolution, const Camera& camera, bool wireframe = false);
-    void runLODCompute(const Camera& camera);
+    void runLODCompute();
     
     // Unified culling functions
     void initializeUnifiedCulling();
     void cleanupUnifiedCulling();
     void updateFrustum(const Camera& camera, float fov, float aspectRatio, float nearPlane, float farPlane);
-    void runUnifiedCulling(const Camera& camera);
-    void renderCellsUnified(glm::vec2 resolution, const Camera& camera, bool wireframe = false);
+    void runUnifiedCulling();
+    void renderCellsUnified(glm::vec2 resolution, bool wireframe = false);
+    void renderImpostors();
     void setDistanceCullingParams(float maxDistance, float fadeStart, float fadeEnd);
     int getVisibleCellCount() const { return visibleCellCount; }
     
@@ -407,17 +464,40 @@ struct CellManager
     void setFogColor(const glm::vec3& color) { fogColor = color; }
 
     void restoreCellsDirectlyToGPUBuffer(const std::vector<ComputeCell> &cells); // For keyframe restoration
-    void setCPUCellData(const std::vector<ComputeCell> &cells); // For keyframe restoration
+    // GPU-to-GPU keyframe capture/restore (see KeyframeArena): cells and adhesions never leave VRAM
+    void copyStateToBuffer(GLuint destination, GLintptr cellOffset, GLintptr adhesionOffset) const;
+    bool restoreStateFromBuffers(GLuint cellSource, GLintptr cellOffset, int cells, GLuint adhesionSource, GLintptr adhesionOffset, int adhesions); // False if the buffers can't grow to hold them
+    void copyStateFrom(CellManager &source); // Takes over another simulation's cells, adhesions and reached modes
+    // Trajectory playback: replaces the read buffer only (for rendering) and drops adhesions, so the
+    // simulation must be restored or reset before it is stepped again
+    void uploadPlaybackCells(const std::vector<ComputeCell> &cells);
+    // Modes reached so far, one bit per mode (small readback, used when capturing keyframes)
+    std::vector<uint32_t> getReachedModes(int modeCount) const;
+    void setReachedModes(const std::vector<uint32_t> &reachedModes);
     
     // Adhesion connection methods for keyframe support
     std::vector<AdhesionConnection> getAdhesionConnections() const; // Get current adhesion connections
     void restoreAdhesionConnections(const std::vector<AdhesionConnection> &connections, int count); // Restore adhesion connections
 
 private:
-    void runPhysicsCompute(float deltaTime);
-    void runUpdateCompute(float deltaTime);
-    void runInternalUpdateCompute(float deltaTime);
+    // The time step reaches these passes through the simulation constants (updateSimulationConstants)
+    void runPhysicsCompute();
+    void runUpdateCompute();
+    void runInternalUpdateCompute();
     void applyCellAdditions();
+    void prepareStepDispatch(); // Fills stepDispatchBuffer from the GPU cell count, before the per-cell passes
+    bool resizeCellBuffers(int newCapacity); // Reallocates every per-cell buffer, copying the ones that hold state
+
+    struct PerCellBuffer
+    {
+        GLuint* buffer;
+        GLsizeiptr bytesPerCell;
+        GPUSubsystem subsystem;
+        GLbitfield flags;
+        bool keepContents;  // Holds simulation state; everything else is regenerated every step or frame
+        GLuint replacement;
+    };
+    std::vector<PerCellBuffer> getPerCellBuffers(); // Every buffer whose size follows cellCapacity
 
     // Spatial grid helper functions
     void runGridClear();
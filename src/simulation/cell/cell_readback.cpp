@@ -0,0 +1,158 @@
+#include "cell_readback.h"
+#include "../../rendering/core/shader_class.h"
+#include "../../utils/timer.h"
+
+#include <cstring>
+
+namespace
+{
+    // Bytes per cell of each packed field, in CellField bit order
+    constexpr GLsizeiptr FIELD_SIZES[] = { sizeof(glm::vec4), sizeof(glm::vec4), sizeof(glm::vec4), sizeof(int), sizeof(float) };
+
+    GLintptr alignOffset(GLintptr offset)
+    {
+        GLintptr alignment = GPUBufferArena::getRangeAlignment();
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+}
+
+void CellReadback::initialize()
+{
+    packShader = new Shader("shaders/cell/management/readback_pack.comp");
+}
+
+void CellReadback::release(ReadbackPool& pool)
+{
+    // Requests still in flight are dropped without running their callbacks, their buffers go back with the fence
+    for (Request& request : pending)
+    {
+        pool.recycle(request.staging, request.fence);
+    }
+    pending.clear();
+
+    if (packShader)
+    {
+        packShader->destroy();
+        delete packShader;
+        packShader = nullptr;
+    }
+}
+
+bool CellReadback::request(ReadbackPool& pool, GLuint cellBuffer, int first, int count, uint32_t fields, Callback callback)
+{
+    if (count <= 0 || first < 0 || fields == 0)
+        return false;
+
+    TimerGPU gpuTimer("Cell Readback");
+
+    Request request;
+    request.first = first;
+    request.count = count;
+    request.fields = fields;
+    request.callback = std::move(callback);
+
+    bool packed = fields != CELL_FIELD_ALL;
+    GLsizeiptr bytes = 0;
+    if (packed)
+    {
+        for (int field = 0; field < PACKED_FIELD_COUNT; field++)
+        {
+            if (fields & (1u << field))
+            {
+                request.fieldOffsets[field] = alignOffset(bytes);
+                bytes = request.fieldOffsets[field] + FIELD_SIZES[field] * count;
+            }
+        }
+    }
+    else
+    {
+        bytes = static_cast<GLsizeiptr>(count) * sizeof(ComputeCell);
+    }
+
+    request.staging = pool.acquire(bytes);
+    if (!request.staging.isValid())
+        return false;
+
+    if (packed)
+    {
+        packShader->use();
+        packShader->setInt("u_first", first);
+        packShader->setInt("u_count", count);
+        packShader->setInt("u_fields", static_cast<int>(fields & CELL_FIELD_PACKED));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellBuffer);
+        for (int field = 0; field < PACKED_FIELD_COUNT; field++)
+        {
+            if (fields & (1u << field))
+            {
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1 + field, request.staging.buffer, request.fieldOffsets[field], FIELD_SIZES[field] * count);
+            }
+        }
+        packShader->dispatch((count + 255) / 256, 1, 1);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        // Shader writes to a persistently mapped buffer need this barrier before the fence makes them visible
+        glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    }
+    else
+    {
+        glCopyNamedBufferSubData(cellBuffer, request.staging.buffer, static_cast<GLintptr>(first) * sizeof(ComputeCell), 0, bytes);
+    }
+
+    request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending.push_back(std::move(request));
+    return true;
+}
+
+void CellReadback::poll(ReadbackPool& pool, bool wait)
+{
+    while (!pending.empty())
+    {
+        Request& request = pending.front();
+        GLenum result = glClientWaitSync(request.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return;
+
+        // Popped before the callback runs, so the callback may queue new requests
+        Request finished = std::move(request);
+        pending.pop_front();
+        complete(pool, finished);
+    }
+}
+
+void CellReadback::complete(ReadbackPool& pool, Request& request)
+{
+    glDeleteSync(request.fence);
+
+    CellReadbackResult result;
+    result.first = request.first;
+    result.fields = request.fields;
+    result.cells.resize(request.count);
+    if (request.fields == CELL_FIELD_ALL)
+    {
+        std::memcpy(result.cells.data(), request.staging.mapped, static_cast<size_t>(request.count) * sizeof(ComputeCell));
+    }
+    else
+    {
+        const glm::vec4* positions = reinterpret_cast<const glm::vec4*>(request.staging.mapped + request.fieldOffsets[0]);
+        const glm::vec4* velocities = reinterpret_cast<const glm::vec4*>(request.staging.mapped + request.fieldOffsets[1]);
+        const glm::quat* orientations = reinterpret_cast<const glm::quat*>(request.staging.mapped + request.fieldOffsets[2]);
+        const int* modes = reinterpret_cast<const int*>(request.staging.mapped + request.fieldOffsets[3]);
+        const float* ages = reinterpret_cast<const float*>(request.staging.mapped + request.fieldOffsets[4]);
+        for (int i = 0; i < request.count; i++)
+        {
+            ComputeCell& cell = result.cells[i];
+            if (request.fields & CELL_FIELD_POSITION) cell.positionAndMass = positions[i];
+            if (request.fields & CELL_FIELD_VELOCITY) cell.velocity = velocities[i];
+            if (request.fields & CELL_FIELD_ORIENTATION) cell.orientation = orientations[i];
+            if (request.fields & CELL_FIELD_MODE) cell.modeIndex = modes[i];
+            if (request.fields & CELL_FIELD_AGE) cell.age = ages[i];
+        }
+    }
+
+    pool.recycle(request.staging);
+
+    if (request.callback)
+    {
+        request.callback(result);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "common_structs.h"
+#include "../../rendering/core/readback_pool.h"
+
+class Shader;
+
+// Fields a cell readback can be limited to
+enum CellField : uint32_t
+{
+    CELL_FIELD_POSITION = 1 << 0,    // positionAndMass (mass is needed for the radius)
+    CELL_FIELD_VELOCITY = 1 << 1,
+    CELL_FIELD_ORIENTATION = 1 << 2,
+    CELL_FIELD_MODE = 1 << 3,        // modeIndex
+    CELL_FIELD_AGE = 1 << 4,
+    CELL_FIELD_PACKED = 0x1F,        // Every field the pack shader can extract
+    CELL_FIELD_ALL = 0xFFFFFFFF      // The whole ComputeCell, copied without packing
+};
+
+struct CellReadbackResult
+{
+    int first = 0;
+    uint32_t fields = 0;
+    std::vector<ComputeCell> cells;  // Fields outside `fields` are left at their defaults
+};
+
+// Explicit GPU -> CPU reads of the cell buffer (see CellManager::readCells / requestCells).
+//
+// A request copies a range of cells into a staging buffer from the ReadbackPool, either whole or
+// packed down to the requested fields by readback_pack.comp, and drops a fence behind the copy.
+// poll() hands every request whose fence has signalled to its callback, so callers only pay for
+// the cells and fields they asked for and never for a full-population sync they didn't need.
+class CellReadback
+{
+public:
+    using Callback = std::function<void(const CellReadbackResult&)>;
+
+    void initialize();
+    void release(ReadbackPool& pool);
+
+    // Queues a copy of cells [first, first + count) of `cellBuffer` behind the commands already submitted.
+    // The caller is responsible for the barrier that makes earlier shader writes visible to the copy.
+    bool request(ReadbackPool& pool, GLuint cellBuffer, int first, int count, uint32_t fields, Callback callback);
+    // Runs the callbacks of finished requests, in order; with `wait` set it blocks until all of them are done
+    void poll(ReadbackPool& pool, bool wait = false);
+
+    int getPendingCount() const { return static_cast<int>(pending.size()); }
+
+private:
+    static constexpr int PACKED_FIELD_COUNT = 5;
+
+    struct Request
+    {
+        GLsync fence = nullptr;
+        ReadbackBuffer staging;
+        int first = 0;
+        int count = 0;
+        uint32_t fields = 0;
+        GLintptr fieldOffsets[PACKED_FIELD_COUNT]{}; // Start of each packed array in the staging buffer
+        Callback callback;
+    };
+
+    void complete(ReadbackPool& pool, Request& request);
+
+    Shader* packShader = nullptr;
+    std::deque<Request> pending;   // Oldest first, fences signal in submission order
+};
@@ -44,8 +44,8 @@ dragSelectedCell(newWorldPos);
 }
 if (isMousePressed && !isDraggingCell)
 {
-// Sync current cell positions from GPU before attempting selection
-syncCellPositionsFromGPU();
+// Only positions and masses are needed for the raycast
+std::vector<ComputeCell> cells = readCells(0, cellCount, CELL_FIELD_POSITION);
 
 // Start new selection with improved raycasting
 glm::vec3 rayOrigin = camera.getPosition();
@@ -53,11 +53,11 @@ glm::vec3 rayDirection = calculateMouseRay(mousePos, screenSize, camera);
 // Debug: Print mouse coordinates and ray info (reduced logging)
 std::cout << "Mouse click at (" << mousePos.x << ", " << mousePos.y << ")\n";
 
-int selectedIndex = selectCellAtPosition(rayOrigin, rayDirection);
+int selectedIndex = selectCellAtPosition(cells, rayOrigin, rayDirection);
 if (selectedIndex >= 0)
 {
 selectedCell.cellIndex = selectedIndex;
-selectedCell.cellData = cpuCells[selectedIndex];
+selectedCell.cellData = getCellData(selectedIndex);
 selectedCell.isValid = true;
 
 // Calculate the distance from camera to the selected cell
@@ -96,19 +96,19 @@ endDrag();
 }
 
 // todo: REWRITE FOR GPU ONLY
-int CellManager::selectCellAtPosition(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection)
+int CellManager::selectCellAtPosition(const std::vector<ComputeCell> &cells, const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection)
 {
 float closestDistance = FLT_MAX;
 int closestCellIndex = -1;
 int intersectionCount = 0;
 
 // Debug output for raycasting
-std::cout << "Testing " << cellCount << " cells for intersection..." << std::endl;
+std::cout << "Testing " << cells.size() << " cells for intersection..." << std::endl;
 
-for (int i = 0; i < cellCount; i++)
+for (int i = 0; i < static_cast<int>(cells.size()); i++)
 {
-glm::vec3 cellPosition = glm::vec3(cpuCells[i].positionAndMass);
-float cellRadius = cpuCells[i].getRadius();
+glm::vec3 cellPosition = glm::vec3(cells[i].positionAndMass);
+float cellRadius = cells[i].getRadius();
 
 float intersectionDistance;
 if (raySphereIntersection(rayOrigin, rayDirection, cellPosition, cellRadius, intersectionDistance))
@@ -144,16 +144,15 @@ void CellManager::dragSelectedCell(const glm::vec3 &newWorldPosition)
 if (!selectedCell.isValid)
 return;
 
-// Update CPU cell data
-cpuCells[selectedCell.cellIndex].positionAndMass.x = newWorldPosition.x;
-cpuCells[selectedCell.cellIndex].positionAndMass.y = newWorldPosition.y;
-cpuCells[selectedCell.cellIndex].positionAndMass.z = newWorldPosition.z;
+// Update cached selected cell data
+selectedCell.cellData.positionAndMass.x = newWorldPosition.x;
+selectedCell.cellData.positionAndMass.y = newWorldPosition.y;
+selectedCell.cellData.positionAndMass.z = newWorldPosition.z;
 
 // Clear velocity when dragging to prevent conflicts with physics
-cpuCells[selectedCell.cellIndex].velocity.x = 0.0f;
-cpuCells[selectedCell.cellIndex].velocity.y = 0.0f;
-cpuCells[selectedCell.cellIndex].velocity.z = 0.0f; // Update cached selected cell data
-selectedCell.cellData = cpuCells[selectedCell.cellIndex];
+selectedCell.cellData.velocity.x = 0.0f;
+selectedCell.cellData.velocity.y = 0.0f;
+selectedCell.cellData.velocity.z = 0.0f;
 
 // Update GPU buffers immediately to ensure compute shaders see the new position
 for (int i = 0; i < 3; i++)
@@ -161,7 +160,7 @@ for (int i = 0; i < 3; i++)
 glNamedBufferSubData(cellBuffer[i],
 selectedCell.cellIndex * sizeof(ComputeCell),
 sizeof(ComputeCell),
-&cpuCells[selectedCell.cellIndex]);
+&selectedCell.cellData);
 }
 }
 
@@ -177,74 +176,21 @@ void CellManager::endDrag()
 if (isDraggingCell && selectedCell.isValid)
 {
 // Reset velocity to zero when ending drag to prevent sudden jumps
-cpuCells[selectedCell.cellIndex].velocity.x = 0.0f;
-cpuCells[selectedCell.cellIndex].velocity.y = 0.0f;
-cpuCells[selectedCell.cellIndex].velocity.z = 0.0f; // Update the GPU buffers with the final state
+selectedCell.cellData.velocity.x = 0.0f;
+selectedCell.cellData.velocity.y = 0.0f;
+selectedCell.cellData.velocity.z = 0.0f; // Update the GPU buffers with the final state
 for (int i = 0; i < 3; i++)
 {
 glNamedBufferSubData(cellBuffer[i],
   selectedCell.cellIndex * sizeof(ComputeCell),
   sizeof(ComputeCell),
-  &cpuCells[selectedCell.cellIndex]);
+  &selectedCell.cellData);
 }
 }
 
 isDraggingCell = false;
 }
 
-void CellManager::syncCellPositionsFromGPU()
-{ // This will fail if the CPU buffer has the wrong size, which will happen once cell division is implemented so i will have to rewrite this
-if (cellCount == 0)
-return;
-
-// OPTIMIZED: Use barrier batching for GPU sync
-addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-flushBarriers();
-
-// Copy data from GPU buffer to staging buffer (no GPU->CPU transfer warning)
-glCopyNamedBufferSubData(getCellReadBuffer(), stagingCellBuffer, 0, 0, cellCount * sizeof(ComputeCell));
-
-// Memory barrier to ensure copy is complete
-addBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-flushBarriers();
-
-// CRITICAL FIX: Use fence sync with longer timeout to ensure GPU operations are complete
-// This prevents the pixel transfer synchronization warning
-GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-GLenum result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 10000000); // Wait up to 10ms
-glDeleteSync(sync);
-
-// If the sync didn't complete in time, fall back to glFinish
-if (result == GL_TIMEOUT_EXPIRED) {
-glFinish();
-}
-
-// Now read from the staging buffer (CPU->CPU, no warning)
-ComputeCell* stagedData = static_cast<ComputeCell*>(mappedCellPtr);
-
-if (stagedData)
-{
-cpuCells.reserve(cellCount);
-// Copy data from staging buffer to CPU storage
-for (int i = 0; i < cellCount; i++)
-{
-if (i < cpuCells.size())
-{
-cpuCells[i] = stagedData[i]; // Sync all data
-} else
-{
-cpuCells.push_back(stagedData[i]);
-}
-}
-
-
-}
-else
-{
-std::cerr << "Failed to access staging buffer for cell data readback" << std::endl;
-}
-}
-
 // todo: REWRITE FOR GPU ONLY
 glm::vec3 CellManager::calculateMouseRay(const glm::vec2 &mousePos, const glm::vec2 &screenSize,
           const Camera &camera)
@@ -0,0 +1,150 @@
+#include "cell_upload_ring.h"
+#include "../../core/config.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+    constexpr GLbitfield RING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Batches start on a cell whose byte offset satisfies the SSBO offset alignment
+    int alignCell(int cell)
+    {
+        static const int step = static_cast<int>(
+            std::lcm<GLsizeiptr>(sizeof(ComputeCell), GPUBufferArena::getRangeAlignment()) / sizeof(ComputeCell));
+        return (cell + step - 1) / step * step;
+    }
+
+    GLintptr cellOffset(int cell)
+    {
+        return static_cast<GLintptr>(cell) * sizeof(ComputeCell);
+    }
+}
+
+ComputeCell* CellUploadRing::allocate(GPUBufferArena& arena, int count)
+{
+    if (count <= 0)
+        return nullptr;
+
+    int needed = batchCount + count;
+    if (batchStart + needed > capacity)
+    {
+        // An empty batch can simply wrap around, one that is already half written has to stay contiguous
+        if (batchCount == 0 && needed <= capacity)
+            batchStart = 0;
+        else if (!grow(arena, std::max({ capacity * 2, needed * 2, config::CELL_UPLOAD_RING_INITIAL_CELLS })))
+            return nullptr;
+    }
+
+    // Only blocks if the GPU hasn't finished reading this range from the previous lap
+    waitForRange(cellOffset(batchStart + batchCount), cellOffset(batchStart + needed));
+
+    ComputeCell* cells = mappedCells + batchStart + batchCount;
+    batchCount = needed;
+    return cells;
+}
+
+GPUBufferRange CellUploadRing::getBatch() const
+{
+    GPUBufferRange range;
+    range.buffer = buffer;
+    range.offset = cellOffset(batchStart);
+    range.size = std::max<GLsizeiptr>(cellOffset(batchCount), sizeof(ComputeCell));
+    return range;
+}
+
+void CellUploadRing::submitBatch()
+{
+    if (batchCount == 0)
+        return;
+
+    inFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), cellOffset(batchStart), cellOffset(batchStart + batchCount) });
+    batchStart = alignCell(batchStart + batchCount);
+    batchCount = 0;
+
+    // Drop the fences that have already signalled so waitForRange has little to look at
+    while (!inFlight.empty())
+    {
+        GLenum result = glClientWaitSync(inFlight.front().fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            break;
+        glDeleteSync(inFlight.front().fence);
+        inFlight.pop_front();
+    }
+}
+
+void CellUploadRing::release(GPUBufferArena& arena)
+{
+    for (Region& region : inFlight)
+    {
+        glDeleteSync(region.fence);
+    }
+    inFlight.clear();
+    if (buffer != 0)
+    {
+        glUnmapNamedBuffer(buffer);
+        arena.destroyBuffer(buffer);
+    }
+    mappedCells = nullptr;
+    capacity = 0;
+    batchStart = 0;
+    batchCount = 0;
+}
+
+bool CellUploadRing::grow(GPUBufferArena& arena, int cells)
+{
+    GLsizeiptr bytes = cellOffset(cells);
+    GLuint newBuffer = arena.createBuffer(GPUSubsystem::Upload, bytes, RING_FLAGS);
+    if (newBuffer == 0)
+        return false;
+    ComputeCell* newCells = static_cast<ComputeCell*>(glMapNamedBufferRange(newBuffer, 0, bytes, RING_FLAGS));
+    if (!newCells)
+    {
+        std::cout << "Error: could not map the cell upload ring\n";
+        arena.destroyBuffer(newBuffer);
+        return false;
+    }
+
+    // The open batch moves to the start of the new ring (coherent writes are visible to the copy)
+    if (batchCount > 0)
+    {
+        glCopyNamedBufferSubData(buffer, newBuffer, cellOffset(batchStart), 0, cellOffset(batchCount));
+    }
+
+    // Submitted batches keep reading the old buffer; GL defers deleting it until they are done
+    for (Region& region : inFlight)
+    {
+        glDeleteSync(region.fence);
+    }
+    inFlight.clear();
+    if (buffer != 0)
+    {
+        glUnmapNamedBuffer(buffer);
+        arena.destroyBuffer(buffer);
+    }
+
+    buffer = newBuffer;
+    mappedCells = newCells;
+    capacity = cells;
+    batchStart = 0;
+    return true;
+}
+
+void CellUploadRing::waitForRange(GLintptr begin, GLintptr end)
+{
+    for (auto it = inFlight.begin(); it != inFlight.end();)
+    {
+        if (it->begin < end && begin < it->end)
+        {
+            glClientWaitSync(it->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(it->fence);
+            it = inFlight.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
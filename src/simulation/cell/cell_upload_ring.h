@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <deque>
+
+#include "common_structs.h"
+#include "../../rendering/core/gpu_buffer_arena.h"
+
+// Persistently mapped ring the CPU writes new cells into (see CellManager::addCellToStagingBuffer).
+//
+// Staged cells go straight into write-combined, coherent GPU-visible memory, so there is no CPU-side
+// vector to fill first and no glNamedBufferSubData copy afterwards. The cells staged since the last submit
+// form one contiguous batch, which the apply_additions pass reads through glBindBufferRange. Each submitted
+// batch gets a fence, and a range is only written again once the fences covering it have signalled.
+// A batch that doesn't fit grows the ring (the part already written is moved over on the GPU).
+class CellUploadRing
+{
+public:
+    // Room for `count` more cells at the end of the open batch, or nullptr if the ring can't grow that far
+    ComputeCell* allocate(GPUBufferArena& arena, int count);
+    int getBatchCount() const { return batchCount; }
+    // The open batch, for binding as the addition queue
+    GPUBufferRange getBatch() const;
+    // Fences the open batch behind the commands that read it and starts a new one
+    void submitBatch();
+    // Forgets the open batch without uploading it
+    void discardBatch() { batchCount = 0; }
+    // Frees the buffer (it is allocated again on the next allocate)
+    void release(GPUBufferArena& arena);
+
+    int getCapacity() const { return capacity; }
+
+private:
+    struct Region
+    {
+        GLsync fence;
+        GLintptr begin;
+        GLintptr end;
+    };
+
+    bool grow(GPUBufferArena& arena, int cells);
+    void waitForRange(GLintptr begin, GLintptr end);
+
+    GLuint buffer{};
+    ComputeCell* mappedCells = nullptr;
+    int capacity = 0;       // Cells the ring holds
+    int batchStart = 0;     // First cell of the open batch (kept aligned for glBindBufferRange)
+    int batchCount = 0;     // Cells written into the open batch
+    std::deque<Region> inFlight;
+};
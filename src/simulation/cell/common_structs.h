@@ -2,26 +2,77 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include "glad/glad.h"
 #include <glm/gtc/quaternion.hpp>
 
+// ============================================================================
+// GPU STRUCT DEFINITIONS
+// ============================================================================
+// Structs shared with shaders are written once as field lists and expanded into both the C++
+// structs below and the GLSL declarations in GPU_STRUCTS_GLSL. Shaders get them with
+// #include "gpu_structs.glsl", so a layout change here is applied to every shader at once.
+// FIELD(cppType, glslType, name, initialValue)   ARRAY(cppType, glslType, name, count)
+
+#define GPU_CPP_FIELD(cppType, glslType, name, init) cppType name = cppType init;
+#define GPU_CPP_ARRAY(cppType, glslType, name, count) cppType name[count]{};
+#define GPU_GLSL_FIELD(cppType, glslType, name, init) "    " #glslType " " #name ";\n"
+#define GPU_GLSL_ARRAY(cppType, glslType, name, count) "    " #glslType " " #name "[" #count "];\n"
+#define GPU_EQUAL_FIELD(cppType, glslType, name, init) && a.name == b.name
+#define GPU_EQUAL_ARRAY(cppType, glslType, name, count) && std::equal(a.name, a.name + count, b.name)
+
 // GPU compute cell structure matching the compute shader
+#define COMPUTE_CELL_FIELDS(FIELD, ARRAY) \
+    /* Physics: */ \
+    FIELD(glm::vec4, vec4, positionAndMass, (0.0f, 0.0f, 0.0f, 1.0f)) /* x, y, z, mass */ \
+    FIELD(glm::vec4, vec4, velocity, (0.0f)) \
+    FIELD(glm::vec4, vec4, acceleration, (0.0f)) \
+    FIELD(glm::quat, vec4, orientation, (1.0f, 0.0f, 0.0f, 0.0f)) /* angular stuff in quaternions to prevent gimbal lock */ \
+    FIELD(glm::quat, vec4, angularVelocity, (1.0f, 0.0f, 0.0f, 0.0f)) \
+    FIELD(glm::quat, vec4, angularAcceleration, (1.0f, 0.0f, 0.0f, 0.0f)) \
+    /* Internal: */ \
+    FIELD(glm::vec4, vec4, signallingSubstances, (0.0f)) /* 4 substances for now */ \
+    FIELD(int, int, modeIndex, (0)) \
+    FIELD(float, float, age, (0.0f)) /* also used for split timer */ \
+    FIELD(float, float, toxins, (0.0f)) \
+    FIELD(float, float, nitrates, (1.0f)) \
+    /* Multi-simulation: */ \
+    FIELD(int, int, genomeOffset, (0)) /* First mode of this cell's genome in the mode buffer, modeIndex is relative to it */ \
+    FIELD(int, int, simulationId, (0)) /* Ensemble simulation this cell belongs to, cells only interact within one */ \
+    ARRAY(int, int, cellPadding, 2)
+
+#define ADHESION_SETTINGS_FIELDS(FIELD, ARRAY) \
+    FIELD(bool, bool, canBreak, (true)) \
+    FIELD(float, float, breakForce, (10.0f)) \
+    FIELD(float, float, restLength, (2.0f)) \
+    FIELD(float, float, linearSpringStiffness, (5.0f)) \
+    FIELD(float, float, linearSpringDamping, (0.5f)) \
+    FIELD(float, float, orientationSpringStiffness, (2.0f)) \
+    FIELD(float, float, orientationSpringDamping, (0.5f)) \
+    FIELD(float, float, maxAngularDeviation, (45.0f)) /* degrees */
+
+#define GPU_MODE_FIELDS(FIELD, ARRAY) \
+    FIELD(glm::vec4, vec4, color, (1.0f)) /* R, G, B, padding */ \
+    FIELD(glm::quat, vec4, orientationA, (1.0f, 0.0f, 0.0f, 0.0f)) \
+    FIELD(glm::quat, vec4, orientationB, (1.0f, 0.0f, 0.0f, 0.0f)) \
+    FIELD(glm::vec4, vec4, splitDirection, (1.0f, 0.0f, 0.0f, 0.0f)) /* x, y, z, padding */ \
+    FIELD(glm::ivec2, ivec2, childModes, (0)) \
+    FIELD(float, float, splitInterval, (5.0f)) \
+    FIELD(int, int, genomeOffset, (0)) /* Offset into global buffer where this genome starts */ \
+    FIELD(AdhesionSettings, AdhesionSettings, adhesionSettings, ()) /* Adhesion settings for the parent cell */ \
+    FIELD(int, int, parentMakeAdhesion, (0)) /* Boolean flag for adhesionSettings creation (0 = false, 1 = true) */ \
+    ARRAY(int, int, padding, 3) /* Padding to ensure 16-byte alignment for GPU compatibility */
+
+#define ADHESION_CONNECTION_FIELDS(FIELD, ARRAY) \
+    FIELD(uint32_t, uint, cellAIndex, (0u)) /* Index of the first cell in the connection */ \
+    FIELD(uint32_t, uint, cellBIndex, (0u)) /* Index of the second cell in the connection */ \
+    FIELD(uint32_t, uint, modeIndex, (0u))  /* Mode index for the connection (to look up adhesion settings) */ \
+    FIELD(uint32_t, uint, isActive, (0u))   /* Whether the connection is currently active (1 = active, 0 = inactive) */
+
 struct ComputeCell {
-    // Physics:
-    glm::vec4 positionAndMass{ 0, 0, 0, 1 };       // x, y, z, mass
-    glm::vec4 velocity{};
-    glm::vec4 acceleration{};
-    glm::quat orientation{ 1., 0., 0., 0. };  // angular stuff in quaternions to prevent gimbal lock
-    glm::quat angularVelocity{ 1., 0., 0., 0. };
-    glm::quat angularAcceleration{ 1., 0., 0., 0. };
-
-    // Internal:
-    glm::vec4 signallingSubstances{}; // 4 substances for now
-    int modeIndex{ 0 };
-    float age{ 0 };                      // also used for split timer
-    float toxins{ 0 };
-    float nitrates{ 1 };
+    COMPUTE_CELL_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
 
     float getRadius() const
     {
@@ -31,37 +82,114 @@ struct ComputeCell {
 
 struct AdhesionSettings
 {
-    bool canBreak = true;
-    float breakForce = 10.0f;
-    float restLength = 2.0f;
-    float linearSpringStiffness = 5.0f;
-    float linearSpringDamping = 0.5f;
-    float orientationSpringStiffness = 2.0f;
-    float orientationSpringDamping = 0.5f;
-    float maxAngularDeviation = 45.0f; // degrees
+    ADHESION_SETTINGS_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
 };
 
+inline bool operator==(const AdhesionSettings& a, const AdhesionSettings& b)
+{
+    return true ADHESION_SETTINGS_FIELDS(GPU_EQUAL_FIELD, GPU_EQUAL_ARRAY);
+}
+
 struct GPUMode {
-    glm::vec4 color{ 1.};  // R, G, B padding
-    glm::quat orientationA{1., 0., 0., 0.};  // quaternion
-    glm::quat orientationB{1., 0., 0., 0.};  // quaternion
-    glm::vec4 splitDirection{ 1., 0. ,0. ,0. };// x, y, z, padding
-    glm::ivec2 childModes{ 0 };
-    float splitInterval{ 5. };
-    int genomeOffset{ 0 };  // Offset into global buffer where this genome starts
-	AdhesionSettings adhesionSettings{}; // Adhesion settings for the parent cell
-    int parentMakeAdhesion{ 0 };  // Boolean flag for adhesionSettings creation (0 = false, 1 = true) + padding
-	int padding[3]{ 0 }; // Padding to ensure 16-byte alignment for GPU compatibility
+    GPU_MODE_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
 };
 
+// Field-wise comparison (memcmp would also compare padding bytes)
+inline bool operator==(const GPUMode& a, const GPUMode& b)
+{
+    return true GPU_MODE_FIELDS(GPU_EQUAL_FIELD, GPU_EQUAL_ARRAY);
+}
+
 struct AdhesionConnection
 {
-    uint32_t cellAIndex; // Index of the first cell in the connection
-    uint32_t cellBIndex; // Index of the second cell in the connection
-    uint32_t modeIndex;  // Mode index for the connection (to look up adhesion settings)
-    uint32_t isActive;   // Whether the connection is currently active (1 = active, 0 = inactive)
+    ADHESION_CONNECTION_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
 };
 
+// GLSL declarations generated from the field lists above (served to shaders as "gpu_structs.glsl")
+inline constexpr const char* GPU_STRUCTS_GLSL =
+    "// Generated from common_structs.h - edit the C++ field lists, not this text\n"
+    "struct ComputeCell {\n" COMPUTE_CELL_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n\n"
+    "struct AdhesionSettings {\n" ADHESION_SETTINGS_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n\n"
+    "struct GPUMode {\n" GPU_MODE_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n\n"
+    "struct AdhesionConnection {\n" ADHESION_CONNECTION_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n";
+
+// ============================================================================
+// GPU UNIFORM BLOCKS
+// ============================================================================
+// std140 constant blocks, uploaded once per frame / per simulation step instead of per-shader uniforms.
+// Only scalars, vec4-sized members, vec3 + float pairs, mat4 and vec4 arrays are used so the C++ layout matches std140.
+
+#define FRAME_CONSTANTS_UBO_BINDING 0
+#define SIMULATION_CONSTANTS_UBO_BINDING 1
+
+#define FRAME_CONSTANTS_FIELDS(FIELD, ARRAY) \
+    FIELD(glm::mat4, mat4, uView, (1.0f)) \
+    FIELD(glm::mat4, mat4, uProjection, (1.0f)) \
+    FIELD(glm::vec3, vec3, uCameraPos, (0.0f)) \
+    FIELD(float, float, uTime, (0.0f)) /* glfwGetTime(), for animation effects */ \
+    FIELD(glm::vec3, vec3, uLightDir, (1.0f)) /* Fixed world-space directional light */ \
+    FIELD(float, float, uSelectedCellRadius, (0.0f)) \
+    FIELD(glm::vec3, vec3, uSelectedCellPos, (-9999.0f)) /* Invalid position when nothing is selected */ \
+    FIELD(float, float, u_maxRenderDistance, (170.0f)) \
+    FIELD(glm::vec3, vec3, uFogColor, (0.1f, 0.15f, 0.3f)) /* Atmospheric/fog color for distant cells */ \
+    FIELD(float, float, u_fadeStartDistance, (30.0f)) \
+    ARRAY(glm::vec4, vec4, u_frustumPlanes, 6) /* xyz = plane normal, w = plane distance */ \
+    FIELD(glm::vec4, vec4, u_lodDistances, (0.0f)) /* Distance thresholds for LOD 0-3 */ \
+    FIELD(float, float, u_fadeEndDistance, (160.0f)) \
+    FIELD(int, int, u_useDistanceCulling, (1)) \
+    FIELD(int, int, u_useLOD, (1)) \
+    FIELD(int, int, u_useFade, (1))
+
+#define SIMULATION_CONSTANTS_FIELDS(FIELD, ARRAY) \
+    FIELD(int, int, u_gridResolution, (0)) \
+    FIELD(float, float, u_gridCellSize, (0.0f)) \
+    FIELD(float, float, u_worldSize, (0.0f)) \
+    FIELD(int, int, u_maxCellsPerGrid, (0)) \
+    FIELD(int, int, u_totalGridCells, (0)) \
+    FIELD(int, int, u_maxCells, (0)) \
+    FIELD(int, int, u_maxAdhesions, (0)) \
+    FIELD(int, int, u_maxConnections, (0)) \
+    FIELD(float, float, u_deltaTime, (0.0f)) \
+    FIELD(float, float, u_damping, (0.98f)) \
+    FIELD(int, int, u_draggedCellIndex, (-1)) /* Index of cell being dragged (-1 if none) */ \
+    FIELD(int, int, u_simulationCellLimit, (0)) /* Cells per ensemble simulation (0 = single simulation, no per-simulation limit) */ \
+    FIELD(int, int, u_ensembleLatticeSide, (0)) /* Ensemble blocks per world axis (0 = single simulation) */ \
+    FIELD(int, int, u_ensembleBlockCells, (0)) /* Grid cells per side of an ensemble block, blocks start at grid cell 0 */ \
+    FIELD(int, int, u_simulationPadding0, (0)) /* Keeps the block a multiple of 16 bytes */ \
+    FIELD(int, int, u_simulationPadding1, (0))
+
+struct FrameConstants {
+    FRAME_CONSTANTS_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
+};
+
+struct SimulationConstants {
+    SIMULATION_CONSTANTS_FIELDS(GPU_CPP_FIELD, GPU_CPP_ARRAY)
+};
+
+#define GPU_STRINGIFY_IMPL(x) #x
+#define GPU_STRINGIFY(x) GPU_STRINGIFY_IMPL(x)
+
+// GLSL uniform blocks generated from the field lists above (served to shaders as "gpu_constants.glsl")
+inline constexpr const char* GPU_CONSTANTS_GLSL =
+    "// Generated from common_structs.h - edit the C++ field lists, not this text\n"
+    "layout(std140, binding = " GPU_STRINGIFY(FRAME_CONSTANTS_UBO_BINDING) ") uniform FrameConstants {\n"
+    FRAME_CONSTANTS_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n\n"
+    "layout(std140, binding = " GPU_STRINGIFY(SIMULATION_CONSTANTS_UBO_BINDING) ") uniform SimulationConstants {\n"
+    SIMULATION_CONSTANTS_FIELDS(GPU_GLSL_FIELD, GPU_GLSL_ARRAY) "};\n";
+
+// std430 layout checks (GLSL bool is 4 bytes, which matches C++ bool followed by float alignment)
+static_assert(sizeof(ComputeCell) == 144, "ComputeCell layout must match gpu_structs.glsl");
+static_assert(sizeof(AdhesionSettings) == 32, "AdhesionSettings layout must match gpu_structs.glsl");
+static_assert(offsetof(GPUMode, adhesionSettings) == 80, "GPUMode layout must match gpu_structs.glsl");
+static_assert(sizeof(GPUMode) == 128, "GPUMode layout must match gpu_structs.glsl");
+static_assert(sizeof(AdhesionConnection) == 16, "AdhesionConnection layout must match gpu_structs.glsl");
+
+// std140 layout checks
+static_assert(offsetof(FrameConstants, u_frustumPlanes) == 192, "FrameConstants layout must match gpu_constants.glsl");
+static_assert(offsetof(FrameConstants, u_lodDistances) == 288, "FrameConstants layout must match gpu_constants.glsl");
+static_assert(sizeof(FrameConstants) == 320, "FrameConstants layout must match gpu_constants.glsl");
+static_assert(sizeof(SimulationConstants) == 64, "SimulationConstants layout must match gpu_constants.glsl");
+
 struct ChildSettings
 {
     int modeNumber = 0;
@@ -0,0 +1,104 @@
+#include "count_snapshot_ring.h"
+
+#include <iostream>
+
+namespace
+{
+    constexpr GLbitfield SNAPSHOT_FLAGS = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+bool CountSnapshotRing::initialize(GPUBufferArena& arena)
+{
+    GLsizeiptr bytes = sizeof(CellCounts) * config::COUNT_SNAPSHOT_SLOTS;
+    buffer = arena.createBuffer(GPUSubsystem::Readback, bytes, SNAPSHOT_FLAGS | GL_CLIENT_STORAGE_BIT);
+    if (buffer == 0)
+        return false;
+    mappedCounts = static_cast<const CellCounts*>(glMapNamedBufferRange(buffer, 0, bytes, SNAPSHOT_FLAGS));
+    if (!mappedCounts)
+    {
+        std::cout << "Error: could not map the cell count snapshot ring\n";
+        arena.destroyBuffer(buffer);
+        return false;
+    }
+    return true;
+}
+
+void CountSnapshotRing::release(GPUBufferArena& arena)
+{
+    reset(CellCounts{});
+    if (buffer != 0)
+    {
+        glUnmapNamedBuffer(buffer);
+        arena.destroyBuffer(buffer);
+    }
+    mappedCounts = nullptr;
+}
+
+void CountSnapshotRing::capture(GLuint countBuffer)
+{
+    if (!mappedCounts)
+        return;
+
+    if (static_cast<int>(pending.size()) == config::COUNT_SNAPSHOT_SLOTS)
+    {
+        retire(false);
+        if (static_cast<int>(pending.size()) == config::COUNT_SNAPSHOT_SLOTS)
+            return; // The GPU is that far behind; the snapshots already queued will do
+    }
+
+    glCopyNamedBufferSubData(countBuffer, buffer, 0, sizeof(CellCounts) * nextSlot, sizeof(CellCounts));
+    fences[nextSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending.push_back(nextSlot);
+    nextSlot = (nextSlot + 1) % config::COUNT_SNAPSHOT_SLOTS;
+}
+
+const CellCounts& CountSnapshotRing::readLatest()
+{
+    retire(false);
+    return latest;
+}
+
+const CellCounts& CountSnapshotRing::readExact(GLuint countBuffer)
+{
+    if (static_cast<int>(pending.size()) == config::COUNT_SNAPSHOT_SLOTS)
+    {
+        retire(true); // Make room, the new snapshot is the only one that matters
+    }
+    capture(countBuffer);
+    retire(true);
+    return latest;
+}
+
+void CountSnapshotRing::reset(const CellCounts& counts)
+{
+    for (int slot : pending)
+    {
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+    }
+    pending.clear();
+    latest = counts;
+}
+
+void CountSnapshotRing::retire(bool wait)
+{
+    // Snapshots are taken in order, so only the oldest pending fence needs checking
+    while (!pending.empty())
+    {
+        int slot = pending.front();
+        GLenum result = glClientWaitSync(fences[slot], wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return;
+
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+        pending.pop_front();
+        if (result == GL_WAIT_FAILED)
+        {
+            // The copy may not have landed, so the slot can't be trusted; keep the previous counts
+            std::cout << "Error: waiting for a cell count snapshot failed\n";
+            continue;
+        }
+        latest = mappedCounts[slot];
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <deque>
+
+#include "../../core/config.h"
+#include "../../rendering/core/gpu_buffer_arena.h"
+
+// Layout of gpuCellCountBuffer
+struct CellCounts
+{
+    GLuint cellCount = 0;
+    GLuint adhesionCount = 0;
+    GLuint liveCellCount = 0;
+    GLuint liveAdhesionCount = 0;
+};
+
+// Fenced copies of the GPU cell counters (see CellManager::updateCounts).
+//
+// capture() copies the counters into the next slot of a small persistently mapped ring and drops a fence
+// behind the copy. readLatest() takes the newest snapshot whose fence has signalled without waiting, so
+// the CPU count is a few ticks old at worst but never a half-written or not-yet-copied value.
+// readExact() captures and waits, for the few decisions that can't work with an old count.
+class CountSnapshotRing
+{
+public:
+    bool initialize(GPUBufferArena& arena);
+    void release(GPUBufferArena& arena);
+
+    // Queues a copy of the counters behind the commands submitted so far; skipped if every slot is still in flight
+    void capture(GLuint countBuffer);
+    // Newest counts the GPU has finished copying, never waits
+    const CellCounts& readLatest();
+    // Counts as of every command submitted so far, waits for the GPU to get there
+    const CellCounts& readExact(GLuint countBuffer);
+    // The CPU knows the counters (it wrote them, or a pass added a known number of cells); older snapshots are dropped
+    void reset(const CellCounts& counts);
+
+    int getPendingCount() const { return static_cast<int>(pending.size()); }
+
+private:
+    void retire(bool wait);
+
+    GLuint buffer{};
+    const CellCounts* mappedCounts = nullptr;
+    GLsync fences[config::COUNT_SNAPSHOT_SLOTS]{};
+    std::deque<int> pending;    // Slots waiting for their fence, oldest first
+    int nextSlot = 0;
+    CellCounts latest;
+};
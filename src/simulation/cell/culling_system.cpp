@@ -26,23 +26,24 @@ void CellManager::initializeUnifiedCulling()
     distanceFadeShader = new Shader("shaders/rendering/sphere/sphere_distance_fade.vert", 
                                    "shaders/rendering/sphere/sphere_distance_fade.frag");
     
-    // Create output buffers for each LOD level
-    for (int i = 0; i < 4; i++) {
-        glCreateBuffers(1, &unifiedOutputBuffers[i]);
-        glNamedBufferStorage(
-            unifiedOutputBuffers[i],
-            cellLimit * sizeof(float) * 16, // 4 vec4s per instance (positionAndRadius, color, orientation, fadeFactor)
-            nullptr,
+    // Initialize ray-cast impostor shaders for the most distant LOD level
+    impostorShader = new Shader("shaders/rendering/sphere/sphere_impostor.vert",
+                                "shaders/rendering/sphere/sphere_impostor.frag");
+    
+    // Impostor quads are built from gl_VertexID, but core profile still requires a bound VAO
+    glCreateVertexArrays(1, &impostorVAO);
+    
+    // Create output buffers for each LOD level (including the impostor level)
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
+        unifiedOutputBuffers[i] = bufferArena.createBuffer(GPUSubsystem::Instances,
+            cellCapacity * sizeof(float) * 16, // 4 vec4s per instance (positionAndRadius, color, orientation, fadeFactor)
             GL_DYNAMIC_STORAGE_BIT
         );
     }
     
     // Create buffer for LOD counts
-    glCreateBuffers(1, &unifiedCountBuffer);
-    glNamedBufferStorage(
-        unifiedCountBuffer,
-        sizeof(uint32_t) * 4, // 4 LOD levels
-        nullptr,
+    unifiedCountBuffer = bufferArena.createBuffer(GPUSubsystem::Instances,
+        sizeof(uint32_t) * UNIFIED_LOD_LEVELS, // 4 mesh LOD levels + impostors
         GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT
     );
     
@@ -63,17 +64,21 @@ void CellManager::cleanupUnifiedCulling()
         distanceFadeShader = nullptr;
     }
     
-    for (int i = 0; i < 4; i++) {
-        if (unifiedOutputBuffers[i] != 0) {
-            glDeleteBuffers(1, &unifiedOutputBuffers[i]);
-            unifiedOutputBuffers[i] = 0;
-        }
+    if (impostorShader) {
+        impostorShader->destroy();
+        delete impostorShader;
+        impostorShader = nullptr;
     }
     
-    if (unifiedCountBuffer != 0) {
-        glDeleteBuffers(1, &unifiedCountBuffer);
-        unifiedCountBuffer = 0;
+    if (impostorVAO != 0) {
+        glDeleteVertexArrays(1, &impostorVAO);
+        impostorVAO = 0;
     }
+    
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
+        bufferArena.destroyBuffer(unifiedOutputBuffers[i]);
+    }
+    bufferArena.destroyBuffer(unifiedCountBuffer);
 }
 
 void CellManager::updateFrustum(const Camera& camera, float fov, float aspectRatio, float nearPlane, float farPlane)
@@ -84,7 +89,7 @@ void CellManager::updateFrustum(const Camera& camera, float fov, float aspectRat
     currentFrustum = FrustumCulling::createFrustum(camera, fov, aspectRatio, nearPlane, farPlane);
 }
 
-void CellManager::runUnifiedCulling(const Camera& camera)
+void CellManager::runUnifiedCulling()
 {
     if (cellCount == 0) return;
     
@@ -93,33 +98,10 @@ void CellManager::runUnifiedCulling(const Camera& camera)
     unifiedCullShader->use();
     
     // Clear count buffer before computation
-    uint32_t zeroCounts[4] = {0, 0, 0, 0};
+    uint32_t zeroCounts[UNIFIED_LOD_LEVELS] = {};
     glNamedBufferSubData(unifiedCountBuffer, 0, sizeof(zeroCounts), zeroCounts);
     
-    // Set camera and distance culling uniforms
-    unifiedCullShader->setVec3("u_cameraPos", camera.getPosition());
-    unifiedCullShader->setFloat("u_maxRenderDistance", maxRenderDistance);
-    unifiedCullShader->setFloat("u_fadeStartDistance", fadeStartDistance);
-    unifiedCullShader->setFloat("u_fadeEndDistance", fadeEndDistance);
-    
-    // Set LOD distance uniforms
-    unifiedCullShader->setFloat("u_lodDistances[0]", lodDistances[0]);
-    unifiedCullShader->setFloat("u_lodDistances[1]", lodDistances[1]);
-    unifiedCullShader->setFloat("u_lodDistances[2]", lodDistances[2]);
-    unifiedCullShader->setFloat("u_lodDistances[3]", lodDistances[3]);
-    
-    // Set mode control uniforms (using setInt since setBool is not available)
-    unifiedCullShader->setInt("u_useDistanceCulling", useDistanceCulling ? 1 : 0);
-    unifiedCullShader->setInt("u_useLOD", useLODSystem ? 1 : 0);
-    unifiedCullShader->setInt("u_useFade", useDistanceCulling ? 1 : 0);
-    
-    // Set frustum planes as uniforms
-    const auto& planes = currentFrustum.getPlanes();
-    for (int i = 0; i < 6; i++) {
-        std::string uniformName = "u_frustumPlanes[" + std::to_string(i) + "]";
-        unifiedCullShader->setVec3(uniformName + ".normal", planes[i].normal);
-        unifiedCullShader->setFloat(uniformName + ".distance", planes[i].distance);
-    }
+    // Camera position, frustum planes, LOD thresholds and fade settings come from the FrameConstants block
     
     // Bind buffers
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
@@ -130,6 +112,7 @@ void CellManager::runUnifiedCulling(const Camera& camera)
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, unifiedOutputBuffers[2]); // LOD 2
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, unifiedOutputBuffers[3]); // LOD 3
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, unifiedCountBuffer);      // LOD counts
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, unifiedOutputBuffers[IMPOSTOR_LOD_LEVEL]); // LOD 4 (impostors)
     
     // Dispatch compute shader
     GLuint numGroups = (cellCount + 63) / 64;
@@ -144,10 +127,13 @@ void CellManager::runUnifiedCulling(const Camera& camera)
     invalidateStatisticsCache();
     
     // Calculate total visible cells for statistics
-    visibleCellCount = lodInstanceCounts[0] + lodInstanceCounts[1] + lodInstanceCounts[2] + lodInstanceCounts[3];
+    visibleCellCount = 0;
+    for (int i = 0; i < UNIFIED_LOD_LEVELS; i++) {
+        visibleCellCount += lodInstanceCounts[i];
+    }
 }
 
-void CellManager::renderCellsUnified(glm::vec2 resolution, const Camera& camera, bool wireframe)
+void CellManager::renderCellsUnified(glm::vec2 resolution, bool wireframe)
 {
     if (cellCount == 0) {
         return;
@@ -159,44 +145,14 @@ void CellManager::renderCellsUnified(glm::vec2 resolution, const Camera& camera,
     }
 
     try {
-        // Update frustum for culling
-        float aspectRatio = resolution.x / resolution.y;
-        if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio)) {
-            aspectRatio = 16.0f / 9.0f;
-        }
-        updateFrustum(camera, config::defaultFrustumFov, aspectRatio, config::defaultFrustumNearPlane, config::defaultFrustumFarPlane);
-        
-        // Run unified culling
-        runUnifiedCulling(camera);
+        // Run unified culling (frustum was updated with the frame constants)
+        runUnifiedCulling();
         
         TimerGPU timer("Unified Cell Rendering");
         
-        // Use distance fade shader
+        // Use distance fade shader, camera/light/fog/selection uniforms come from the FrameConstants block
         distanceFadeShader->use();
         
-        // Set up camera matrices
-        glm::mat4 view = camera.getViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(config::defaultFrustumFov), aspectRatio, config::defaultFrustumNearPlane, config::defaultFrustumFarPlane);
-        
-        // Set uniforms
-        distanceFadeShader->setMat4("uProjection", projection);
-        distanceFadeShader->setMat4("uView", view);
-        distanceFadeShader->setVec3("uCameraPos", camera.getPosition());
-        distanceFadeShader->setVec3("uLightDir", glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f)));
-        distanceFadeShader->setVec3("uFogColor", fogColor);
-        
-        // Selection highlighting uniforms
-        if (selectedCell.isValid) {
-            glm::vec3 selectedPos = glm::vec3(selectedCell.cellData.positionAndMass);
-            float selectedRadius = selectedCell.cellData.getRadius();
-            distanceFadeShader->setVec3("uSelectedCellPos", selectedPos);
-            distanceFadeShader->setFloat("uSelectedCellRadius", selectedRadius);
-        } else {
-            distanceFadeShader->setVec3("uSelectedCellPos", glm::vec3(-9999.0f));
-            distanceFadeShader->setFloat("uSelectedCellRadius", 0.0f);
-        }
-        distanceFadeShader->setFloat("uTime", static_cast<float>(glfwGetTime()));
-        
         // Enable depth testing (no blending needed since we're not using transparency)
         glEnable(GL_DEPTH_TEST);
         
@@ -213,7 +169,7 @@ void CellManager::renderCellsUnified(glm::vec2 resolution, const Camera& camera,
         }
         
         // Render each LOD level with its appropriate mesh detail and instance data
-        for (int lodLevel = 0; lodLevel < 4; lodLevel++) {
+        for (int lodLevel = 0; lodLevel < SphereMesh::LOD_LEVELS; lodLevel++) {
             if (lodInstanceCounts[lodLevel] > 0) {
                 // Setup sphere mesh to use the unified output buffer with fade factor
                 sphereMesh.setupLODInstanceBufferWithFade(lodLevel, unifiedOutputBuffers[lodLevel]);
@@ -227,6 +183,9 @@ void CellManager::renderCellsUnified(glm::vec2 resolution, const Camera& camera,
         glDisable(GL_CULL_FACE);
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         
+        // Most distant cells are ray-cast on a single quad each
+        renderImpostors();
+        
     } catch (const std::exception &e) {
         std::cerr << "Exception in renderCellsUnified: " << e.what() << "\n";
         // Fall back to regular rendering
@@ -243,7 +202,25 @@ void CellManager::renderCellsUnified(glm::vec2 resolution, const Camera& camera,
     }
 }
 
-
+void CellManager::renderImpostors()
+{
+    if (lodInstanceCounts[IMPOSTOR_LOD_LEVEL] <= 0 || !impostorShader) {
+        return;
+    }
+    
+    TimerGPU timer("Impostor Rendering");
+    
+    impostorShader->use(); // All uniforms come from the FrameConstants block
+    
+    // The vertex shader pulls instance data straight from the culling output
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, unifiedOutputBuffers[IMPOSTOR_LOD_LEVEL]);
+    
+    // Quads always face the camera and the fragment shader writes its own depth
+    glEnable(GL_DEPTH_TEST);
+    glBindVertexArray(impostorVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, lodInstanceCounts[IMPOSTOR_LOD_LEVEL]);
+    glBindVertexArray(0);
+}
 
 void CellManager::setDistanceCullingParams(float maxDistance, float fadeStart, float fadeEnd)
 {
@@ -0,0 +1,76 @@
+#include "genome_table.h"
+#include "cell_manager.h"
+
+#include <algorithm>
+#include <iostream>
+
+int GenomeTable::append(const GenomeData& genome)
+{
+    Entry entry;
+    entry.genome = genome;
+    entry.modeOffset = getModeCount();
+    entry.modeCapacity = static_cast<int>(genome.modes.size());
+    entries.push_back(std::move(entry));
+    return static_cast<int>(entries.size()) - 1;
+}
+
+bool GenomeTable::replace(int id, const GenomeData& genome)
+{
+    if (id < 0 || id >= getGenomeCount())
+    {
+        return false;
+    }
+
+    Entry& entry = entries[id];
+    int modeCount = static_cast<int>(genome.modes.size());
+    if (modeCount > entry.modeCapacity)
+    {
+        if (id != getGenomeCount() - 1)
+        {
+            std::cout << "Warning: genome " << id << " grew to " << modeCount << " modes but only has "
+                << entry.modeCapacity << " slots between the genomes around it\n";
+            return false;
+        }
+        entry.modeCapacity = modeCount;
+    }
+    entry.genome = genome;
+    return true;
+}
+
+bool GenomeTable::assign(std::vector<Entry> newEntries)
+{
+    int end = 0;
+    for (const Entry& entry : newEntries)
+    {
+        if (entry.modeOffset < end || entry.modeCapacity < static_cast<int>(entry.genome.modes.size()))
+        {
+            return false;
+        }
+        end = entry.modeOffset + entry.modeCapacity;
+    }
+    entries = std::move(newEntries);
+    return true;
+}
+
+std::vector<GPUMode> GenomeTable::buildGPUModes(int id) const
+{
+    const Entry& entry = entries[id];
+    std::vector<GPUMode> gpuModes;
+    gpuModes.reserve(entry.genome.modes.size());
+    for (const ModeSettings& mode : entry.genome.modes)
+    {
+        gpuModes.push_back(toGPUMode(mode, entry.modeOffset));
+    }
+    return gpuModes;
+}
+
+std::vector<GPUMode> GenomeTable::buildGPUModes() const
+{
+    std::vector<GPUMode> gpuModes(getModeCount(), GPUMode{});
+    for (int id = 0; id < getGenomeCount(); id++)
+    {
+        std::vector<GPUMode> genomeModes = buildGPUModes(id);
+        std::copy(genomeModes.begin(), genomeModes.end(), gpuModes.begin() + entries[id].modeOffset);
+    }
+    return gpuModes;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include "common_structs.h"
+
+// CPU side of the mode buffer: every genome hosted by a CellManager, each owning a contiguous run of mode slots.
+// Cells store the offset of their genome's run (ComputeCell::genomeOffset) and a mode index relative to it,
+// so genomes never need to know where they ended up and child mode numbers stay as the genome editor wrote them.
+// Slots are never moved once handed out: a replaced genome keeps its offset (only the last genome may grow),
+// because cells already in the buffers point at it.
+class GenomeTable
+{
+public:
+    struct Entry
+    {
+        GenomeData genome;
+        int modeOffset = 0;   // First mode slot of this genome
+        int modeCapacity = 0; // Slots reserved, >= genome.modes.size()
+    };
+
+    void clear() { entries.clear(); }
+
+    // Appends a genome after the last one; returns its genome id
+    int append(const GenomeData& genome);
+    // Undoes the last append (e.g. when its modes couldn't be uploaded)
+    void removeLast() { if (!entries.empty()) entries.pop_back(); }
+    // Replaces genome `id` in its slots; returns false if it has grown and isn't the last genome
+    bool replace(int id, const GenomeData& genome);
+
+    // Restores a table as saved (checkpoints keep the offsets cells refer to); returns false if the runs overlap
+    bool assign(std::vector<Entry> newEntries);
+
+    // GPU modes of one genome, with every mode tagged with the genome's offset
+    std::vector<GPUMode> buildGPUModes(int id) const;
+    // GPU modes of every slot in use, in mode buffer order (unused slack stays zeroed)
+    std::vector<GPUMode> buildGPUModes() const;
+
+    int getGenomeCount() const { return static_cast<int>(entries.size()); }
+    bool empty() const { return entries.empty(); }
+    const Entry& operator[](int id) const { return entries[id]; }
+    int getModeOffset(int id) const { return entries[id].modeOffset; }
+    // Mode slots in use (end of the last genome's run), i.e. how large the mode buffer has to be
+    int getModeCount() const { return entries.empty() ? 0 : entries.back().modeOffset + entries.back().modeCapacity; }
+
+private:
+    std::vector<Entry> entries;
+};
@@ -1,5 +1,4 @@
 #include "cell_manager.h"
-#include "../../rendering/camera/camera.h"
 #include "../../core/config.h"
 #include "../../ui/ui_manager.h"
 #include <iostream>
@@ -7,6 +6,7 @@
 #include <cfloat>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -19,87 +19,23 @@
 
 void CellManager::initializeGizmoBuffers()
 {
-    // Create buffer for gizmo line vertices (each cell produces 6 vertices for 3 lines)
-    // Each vertex now has vec4 position + vec4 color = 8 floats = 32 bytes
-    glCreateBuffers(1, &gizmoBuffer);
-    glNamedBufferData(gizmoBuffer,
-        cellLimit * 6 * sizeof(glm::vec4) * 2, // position + color for each vertex
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
-    
-    // Create VAO for gizmo rendering
+    // Gizmo lines are generated in gizmo.vert from the cell buffer (6 vertices per cell, 3 lines),
+    // so no vertex storage is needed. Create an empty VAO to satisfy the core profile.
     glCreateVertexArrays(1, &gizmoVAO);
-    
-    // Create VBO that will be bound to the gizmo buffer
-    glCreateBuffers(1, &gizmoVBO);
-    glNamedBufferData(gizmoVBO,
-        cellLimit * 6 * sizeof(glm::vec4) * 2,
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
-    
-    // Set up VAO with vertex attributes (stride is now 2 vec4s = 32 bytes)
-    glVertexArrayVertexBuffer(gizmoVAO, 0, gizmoVBO, 0, sizeof(glm::vec4) * 2);
-    
-    // Position attribute (vec4)
-    glEnableVertexArrayAttrib(gizmoVAO, 0);
-    glVertexArrayAttribFormat(gizmoVAO, 0, 4, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(gizmoVAO, 0, 0);
-    
-    // Color attribute (vec4, offset by 16 bytes)
-    glEnableVertexArrayAttrib(gizmoVAO, 1);
-    glVertexArrayAttribFormat(gizmoVAO, 1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4));
-    glVertexArrayAttribBinding(gizmoVAO, 1, 0);
 }
 
-void CellManager::updateGizmoData()
-{
-    if (cellCount == 0) return;
-    
-    TimerGPU timer("Gizmo Data Update");
-    
-    gizmoExtractShader->use();
-    
-    // Bind cell data as input
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
-    // Bind gizmo buffer as output
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gizmoBuffer);
-    // Bind cell count buffer
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gpuCellCountBuffer);
-    
-    // Dispatch compute shader
-    GLuint numGroups = (cellCount + 63) / 64;
-    gizmoExtractShader->dispatch(numGroups, 1, 1);
-    
-    // Use targeted barrier for buffer copy
-    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    flushBarriers();
-    
-    // Copy data from compute buffer to VBO for rendering
-    glCopyNamedBufferSubData(gizmoBuffer, gizmoVBO, 0, 0, cellCount * 6 * sizeof(glm::vec4) * 2);
-    
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
-
-void CellManager::renderGizmos(glm::vec2 resolution, const Camera& camera, bool showGizmos)
+void CellManager::renderGizmos(bool showGizmos)
 {
     if (!showGizmos || cellCount == 0) return;
     
-    // Update gizmo data from current cell orientations
-    updateGizmoData();
-    
     TimerGPU timer("Gizmo Rendering");
     
     gizmoShader->use();
     
-    // Set up camera matrices
-    glm::mat4 view = camera.getViewMatrix();
-    float aspectRatio = resolution.x / resolution.y;
-    if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio))
-    {
-        aspectRatio = 16.0f / 9.0f;
-    }
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
+    // Vertex shader pulls cell orientations directly from the current read buffer
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
     
-    gizmoShader->setMat4("uProjection", projection);
-    gizmoShader->setMat4("uView", view);
+    // Camera matrices come from the FrameConstants block
     
     // Enable depth testing and depth writing for proper depth sorting with ring gizmos
     glEnable(GL_DEPTH_TEST);
@@ -117,16 +53,6 @@ void CellManager::renderGizmos(glm::vec2 resolution, const Camera& camera, bool
 
 void CellManager::cleanupGizmos()
 {
-    if (gizmoBuffer != 0)
-    {
-        glDeleteBuffers(1, &gizmoBuffer);
-        gizmoBuffer = 0;
-    }
-    if (gizmoVBO != 0)
-    {
-        glDeleteBuffers(1, &gizmoVBO);
-        gizmoVBO = 0;
-    }
     if (gizmoVAO != 0)
     {
         glDeleteVertexArrays(1, &gizmoVAO);
@@ -140,89 +66,56 @@ void CellManager::cleanupGizmos()
 
 void CellManager::initializeRingGizmoBuffers()
 {
-    // Create buffer for ring vertices (each cell produces 2 rings * 32 segments * 6 vertices = 384 vertices)
-    // Each vertex has vec4 position + vec4 color = 8 floats = 32 bytes
-    glCreateBuffers(1, &ringGizmoBuffer);
-    glNamedBufferData(ringGizmoBuffer,
-        cellLimit * 384 * sizeof(glm::vec4) * 2, // position + color for each vertex
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
-    
-    // Create VAO for ring gizmo rendering
-    glCreateVertexArrays(1, &ringGizmoVAO);
-    
-    // Create VBO that will be bound to the ring gizmo buffer
-    glCreateBuffers(1, &ringGizmoVBO);
-    glNamedBufferData(ringGizmoVBO,
-        cellLimit * 384 * sizeof(glm::vec4) * 2,
-        nullptr, GL_DYNAMIC_COPY);  // GPU produces data, GPU consumes for rendering
+    // Ring geometry is a single shared template (2 rings * 32 segments * 6 vertices = 384 vertices)
+    // instanced once per drawn cell; ring_gizmo.vert places it using the cell orientation and split direction.
+    // Each template vertex is vec4(cos(angle), sin(angle), isOuterEdge, isSecondRing), so the whole overlay is ~6 KB.
+    constexpr int segmentsPerRing = 32;
+    
+    // Per-triangle corners within a segment: {use next angle, use outer edge}
+    // First ring: (inner1, inner2, outer1), (outer1, inner2, outer2)
+    // Second ring uses the opposite winding so it is visible from the other side
+    const int firstRingCorners[6][2] = { {0, 0}, {1, 0}, {0, 1}, {0, 1}, {1, 0}, {1, 1} };
+    const int secondRingCorners[6][2] = { {0, 0}, {0, 1}, {1, 0}, {0, 1}, {1, 1}, {1, 0} };
+    
+    std::vector<glm::vec4> ringTemplate;
+    ringTemplate.reserve(RING_GIZMO_TEMPLATE_VERTICES);
+    for (int ring = 0; ring < 2; ring++) {
+        const int (*corners)[2] = ring == 0 ? firstRingCorners : secondRingCorners;
+        for (int segment = 0; segment < segmentsPerRing; segment++) {
+            for (int corner = 0; corner < 6; corner++) {
+                int angleIndex = (segment + corners[corner][0]) % segmentsPerRing;
+                float angle = 2.0f * static_cast<float>(M_PI) * angleIndex / segmentsPerRing;
+                ringTemplate.emplace_back(std::cos(angle), std::sin(angle),
+                                          static_cast<float>(corners[corner][1]), static_cast<float>(ring));
+            }
+        }
+    }
     
-    // Set up VAO with vertex attributes (stride is now 2 vec4s = 32 bytes)
-    glVertexArrayVertexBuffer(ringGizmoVAO, 0, ringGizmoVBO, 0, sizeof(glm::vec4) * 2);
+    ringGizmoTemplateVBO = bufferArena.createBuffer(GPUSubsystem::Gizmo,
+        ringTemplate.size() * sizeof(glm::vec4),
+        0, ringTemplate.data()); // Immutable, never updated
     
-    // Position attribute (vec4)
+    glCreateVertexArrays(1, &ringGizmoVAO);
+    glVertexArrayVertexBuffer(ringGizmoVAO, 0, ringGizmoTemplateVBO, 0, sizeof(glm::vec4));
     glEnableVertexArrayAttrib(ringGizmoVAO, 0);
     glVertexArrayAttribFormat(ringGizmoVAO, 0, 4, GL_FLOAT, GL_FALSE, 0);
     glVertexArrayAttribBinding(ringGizmoVAO, 0, 0);
-    
-    // Color attribute (vec4, offset by 16 bytes)
-    glEnableVertexArrayAttrib(ringGizmoVAO, 1);
-    glVertexArrayAttribFormat(ringGizmoVAO, 1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4));
-    glVertexArrayAttribBinding(ringGizmoVAO, 1, 0);
-}
-
-void CellManager::updateRingGizmoData()
-{
-    if (cellCount == 0) return;
-    
-    TimerGPU timer("Ring Gizmo Data Update");
-    
-    ringGizmoExtractShader->use();
-    
-    // Bind cell data as input
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
-    // Bind mode data as input
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, modeBuffer);
-    // Bind ring gizmo buffer as output
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, ringGizmoBuffer);
-    // Bind cell count buffer
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gpuCellCountBuffer);
-    
-    // Dispatch compute shader
-    GLuint numGroups = (cellCount + 63) / 64;
-    ringGizmoExtractShader->dispatch(numGroups, 1, 1);
-    
-    // Use targeted barrier for buffer copy
-    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    flushBarriers();
-    
-    // Copy data from compute buffer to VBO for rendering
-    glCopyNamedBufferSubData(ringGizmoBuffer, ringGizmoVBO, 0, 0, cellCount * 384 * sizeof(glm::vec4) * 2);
-    
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void CellManager::renderRingGizmos(glm::vec2 resolution, const Camera& camera, const UIManager& uiManager)
+void CellManager::renderRingGizmos(const UIManager& uiManager)
 {
     if (!uiManager.showOrientationGizmos || cellCount == 0) return;
     
-    // Update ring gizmo data from current cell orientations and split directions
-    updateRingGizmoData();
-    
     TimerGPU timer("Ring Gizmo Rendering");
     
     ringGizmoShader->use();
     
-    // Set up camera matrices
-    glm::mat4 view = camera.getViewMatrix();
-    float aspectRatio = resolution.x / resolution.y;
-    if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio))
-    {
-        aspectRatio = 16.0f / 9.0f;
-    }
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
+    // Vertex shader pulls cell orientations and split directions directly from the GPU buffers
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, modeBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, unifiedOutputBuffers[0]);
     
-    ringGizmoShader->setMat4("uProjection", projection);
-    ringGizmoShader->setMat4("uView", view);
+    // Camera matrices come from the FrameConstants block
     
     // Enable face culling so rings are only visible from one side
     glEnable(GL_CULL_FACE);
@@ -237,16 +130,28 @@ void CellManager::renderRingGizmos(glm::vec2 resolution, const Camera& camera, c
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    // Render ring gizmo triangles (each cell has 2 rings, each ring has 32 segments * 6 vertices)
     glBindVertexArray(ringGizmoVAO);
     
-    // Render each ring as triangles - both rings with proper depth testing
-    // Blue ring will be visible from one side, red ring from the other side
-    for (int i = 0; i < cellCount; i++) {
-        // Blue ring (positioned forward along split direction)
-        glDrawArrays(GL_TRIANGLES, i * 384, 192);
-        // Red ring (positioned backward along split direction)
-        glDrawArrays(GL_TRIANGLES, i * 384 + 192, 192);
+    // Only draw rings where they are readable: visible cells in the nearest LOD levels from this
+    // frame's culling pass, plus the selected cell wherever it is
+    int maxRingLod = std::min(config::ringGizmoMaxLod, SphereMesh::LOD_LEVELS - 1);
+    bool usingCulledInstances = useFrustumCulling || useDistanceCulling || useLODSystem;
+    bool drawSelected = selectedCell.isValid && selectedCell.cellIndex < cellCount;
+    
+    if (usingCulledInstances) {
+        // The selected cell is skipped in the buckets (wherever culling put it) so its own draw below is its only ring
+        ringGizmoShader->setInt("uCellIndexOverride", -1);
+        ringGizmoShader->setInt("uSkipCellIndex", drawSelected ? selectedCell.cellIndex : -1);
+        for (int lod = 0; lod <= maxRingLod; lod++) {
+            if (lodInstanceCounts[lod] <= 0) continue;
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, unifiedOutputBuffers[lod]);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, RING_GIZMO_TEMPLATE_VERTICES, lodInstanceCounts[lod]);
+        }
+    }
+    
+    if (drawSelected) {
+        ringGizmoShader->setInt("uCellIndexOverride", selectedCell.cellIndex);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, RING_GIZMO_TEMPLATE_VERTICES, 1);
     }
     
     glBindVertexArray(0);
@@ -259,16 +164,7 @@ void CellManager::renderRingGizmos(glm::vec2 resolution, const Camera& camera, c
 
 void CellManager::cleanupRingGizmos()
 {
-    if (ringGizmoBuffer != 0)
-    {
-        glDeleteBuffers(1, &ringGizmoBuffer);
-        ringGizmoBuffer = 0;
-    }
-    if (ringGizmoVBO != 0)
-    {
-        glDeleteBuffers(1, &ringGizmoVBO);
-        ringGizmoVBO = 0;
-    }
+    bufferArena.destroyBuffer(ringGizmoTemplateVBO);
     if (ringGizmoVAO != 0)
     {
         glDeleteVertexArrays(1, &ringGizmoVAO);
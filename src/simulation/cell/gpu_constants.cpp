@@ -0,0 +1,107 @@
+#include "cell_manager.h"
+#include "../../rendering/camera/camera.h"
+#include "../../core/config.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// ============================================================================
+// CONSTANT UNIFORM BUFFERS
+// ============================================================================
+// Values shared by many shaders live in two std140 uniform blocks instead of per-shader uniforms.
+// FrameConstants is uploaded once per rendered frame, SimulationConstants once per simulation step.
+// Each CellManager owns its own pair, so the preview and main simulations rebind theirs before use.
+
+void CellManager::initializeConstantBuffers()
+{
+    frameConstantsUBO = bufferArena.createBuffer(GPUSubsystem::Constants, sizeof(FrameConstants), GL_DYNAMIC_STORAGE_BIT, &frameConstants);
+    simulationConstantsUBO = bufferArena.createBuffer(GPUSubsystem::Constants, sizeof(SimulationConstants), GL_DYNAMIC_STORAGE_BIT, &simulationConstants);
+
+    // Cells can be added before the first updateCells call, so the limits have to be valid right away
+    updateSimulationConstants(config::physicsTimeStep);
+}
+
+void CellManager::cleanupConstantBuffers()
+{
+    bufferArena.destroyBuffer(frameConstantsUBO);
+    bufferArena.destroyBuffer(simulationConstantsUBO);
+}
+
+void CellManager::updateFrameConstants(glm::vec2 resolution, const Camera &camera)
+{
+    float aspectRatio = resolution.x / resolution.y;
+    if (aspectRatio <= 0.0f || !std::isfinite(aspectRatio))
+    {
+        aspectRatio = 16.0f / 9.0f;
+    }
+
+    // Camera matrices (only calculated once per frame, shared by cells, impostors and gizmos)
+    frameConstants.uView = camera.getViewMatrix();
+    frameConstants.uProjection = glm::perspective(glm::radians(config::defaultFrustumFov), aspectRatio,
+        config::defaultFrustumNearPlane, config::defaultFrustumFarPlane);
+    frameConstants.uCameraPos = camera.getPosition();
+    frameConstants.uTime = static_cast<float>(glfwGetTime());
+    frameConstants.uLightDir = glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f)); // Fixed world-space directional light (like sunlight)
+    frameConstants.uFogColor = fogColor;
+
+    // Selection highlighting
+    if (selectedCell.isValid)
+    {
+        frameConstants.uSelectedCellPos = glm::vec3(selectedCell.cellData.positionAndMass);
+        frameConstants.uSelectedCellRadius = selectedCell.cellData.getRadius();
+    }
+    else
+    {
+        frameConstants.uSelectedCellPos = glm::vec3(-9999.0f); // Invalid position
+        frameConstants.uSelectedCellRadius = 0.0f;
+    }
+
+    // Culling and LOD settings
+    updateFrustum(camera, config::defaultFrustumFov, aspectRatio, config::defaultFrustumNearPlane, config::defaultFrustumFarPlane);
+    const auto& planes = currentFrustum.getPlanes();
+    for (int i = 0; i < 6; i++)
+    {
+        frameConstants.u_frustumPlanes[i] = glm::vec4(planes[i].normal, planes[i].distance);
+    }
+    frameConstants.u_lodDistances = glm::vec4(lodDistances[0], lodDistances[1], lodDistances[2], lodDistances[3]);
+    frameConstants.u_maxRenderDistance = maxRenderDistance;
+    frameConstants.u_fadeStartDistance = fadeStartDistance;
+    frameConstants.u_fadeEndDistance = fadeEndDistance;
+    frameConstants.u_useDistanceCulling = useDistanceCulling ? 1 : 0;
+    frameConstants.u_useLOD = useLODSystem ? 1 : 0;
+    frameConstants.u_useFade = useDistanceCulling ? 1 : 0;
+
+    glNamedBufferSubData(frameConstantsUBO, 0, sizeof(FrameConstants), &frameConstants);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_UBO_BINDING, frameConstantsUBO);
+}
+
+void CellManager::updateSimulationConstants(float deltaTime)
+{
+    simulationConstants.u_gridResolution = config::GRID_RESOLUTION;
+    simulationConstants.u_gridCellSize = config::GRID_CELL_SIZE;
+    simulationConstants.u_worldSize = config::WORLD_SIZE;
+    simulationConstants.u_maxCellsPerGrid = config::MAX_CELLS_PER_GRID;
+    simulationConstants.u_totalGridCells = config::TOTAL_GRID_CELLS;
+    simulationConstants.u_maxCells = std::min(cellLimit, cellCapacity); // The shaders must not write past the allocated buffers
+    simulationConstants.u_maxAdhesions = cellCapacity * config::ADHESIONS_PER_CELL;
+    simulationConstants.u_maxConnections = cellCapacity;
+    simulationConstants.u_deltaTime = deltaTime;
+    simulationConstants.u_damping = 0.98f;
+    simulationConstants.u_simulationCellLimit = simulationCellLimit;
+    simulationConstants.u_ensembleLatticeSide = ensembleLatticeSide;
+    simulationConstants.u_ensembleBlockCells = ensembleLatticeSide > 0 ? config::GRID_RESOLUTION / ensembleLatticeSide : 0;
+
+    // Pass dragged cell index to skip its physics and position updates
+    simulationConstants.u_draggedCellIndex = (isDraggingCell && selectedCell.isValid) ? selectedCell.cellIndex : -1;
+
+    glNamedBufferSubData(simulationConstantsUBO, 0, sizeof(SimulationConstants), &simulationConstants);
+    bindSimulationConstants();
+}
+
+void CellManager::bindSimulationConstants() const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, SIMULATION_CONSTANTS_UBO_BINDING, simulationConstantsUBO);
+}
@@ -0,0 +1,72 @@
+#include "keyframe_arena.h"
+#include "cell_manager.h"
+#include "../../core/config.h"
+
+namespace
+{
+    // Keep every range aligned like an SSBO offset would need to be
+    GLintptr alignOffset(GLintptr offset)
+    {
+        constexpr GLintptr alignment = 256;
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+void KeyframeArena::reset()
+{
+    slots.clear();
+    usedBytes = 0;
+}
+
+void KeyframeArena::truncate(int count)
+{
+    if (count < 0 || count >= static_cast<int>(slots.size()))
+        return;
+    slots.resize(count);
+
+    // Slots are allocated linearly, so everything after the last kept slot is free again
+    usedBytes = 0;
+    if (!slots.empty())
+    {
+        const Slot& last = slots.back();
+        usedBytes = last.adhesionOffset + last.adhesionCount * sizeof(AdhesionConnection);
+    }
+}
+
+int KeyframeArena::capture(CellManager& cellManager)
+{
+    // Allocated on first use, so builds that never capture don't cost any VRAM
+    if (buffer == 0)
+    {
+        buffer = cellManager.bufferArena.createBuffer(GPUSubsystem::Keyframes, config::KEYFRAME_ARENA_BYTES, 0); // GPU only, filled by buffer copies
+        if (buffer == 0)
+            return -1; // Refused, every keyframe goes to the CPU store
+        capacity = config::KEYFRAME_ARENA_BYTES;
+    }
+
+    // The regular count can be a few ticks old, a keyframe has to hold every cell
+    cellManager.updateCounts(true);
+
+    Slot slot;
+    slot.cellCount = cellManager.getCellCount();
+    slot.adhesionCount = cellManager.adhesionCount;
+    slot.cellOffset = alignOffset(usedBytes);
+    slot.adhesionOffset = alignOffset(slot.cellOffset + slot.cellCount * sizeof(ComputeCell));
+    GLintptr end = slot.adhesionOffset + slot.adhesionCount * sizeof(AdhesionConnection);
+    if (end > capacity)
+        return -1;
+
+    cellManager.copyStateToBuffer(buffer, slot.cellOffset, slot.adhesionOffset);
+    usedBytes = end;
+    slots.push_back(slot);
+    return static_cast<int>(slots.size()) - 1;
+}
+
+bool KeyframeArena::restore(int slot, CellManager& cellManager) const
+{
+    if (slot < 0 || slot >= static_cast<int>(slots.size()))
+        return false;
+
+    const Slot& s = slots[slot];
+    return cellManager.restoreStateFromBuffers(buffer, s.cellOffset, s.cellCount, buffer, s.adhesionOffset, s.adhesionCount);
+}
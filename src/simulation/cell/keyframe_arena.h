@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+struct CellManager;
+
+// GPU-resident keyframe storage for preview-scale populations.
+// One large buffer is sub-allocated linearly; capturing a keyframe copies the cell read buffer and the
+// adhesion connections into the next free range with glCopyNamedBufferSubData, and restoring copies
+// them back into the CellManager's buffers. Nothing goes over PCIe except the 16 byte count block.
+// When the arena is full, capture returns -1 and the caller falls back to the CPU KeyframeStore.
+// The buffer is allocated from the capturing CellManager's GPUBufferArena (Keyframes subsystem) and is
+// freed with it, so keyframes must always be captured from the same CellManager (the keyframe builder).
+class KeyframeArena
+{
+public:
+    // Forgets all keyframes (the buffer is kept for the next build)
+    void reset();
+    // Forgets slots from `count` on, freeing their space for new captures
+    void truncate(int count);
+
+    // Copies the current state of cellManager into the arena; returns the slot index, or -1 if it doesn't fit
+    int capture(CellManager& cellManager);
+    // Restores a captured slot into cellManager; returns false for an invalid slot
+    bool restore(int slot, CellManager& cellManager) const;
+
+    size_t getUsedBytes() const { return static_cast<size_t>(usedBytes); }
+    size_t getCapacity() const { return static_cast<size_t>(capacity); }
+
+private:
+    struct Slot
+    {
+        GLintptr cellOffset = 0;
+        int cellCount = 0;
+        GLintptr adhesionOffset = 0;
+        int adhesionCount = 0;
+    };
+
+    GLuint buffer{};
+    GLsizeiptr capacity{};
+    GLintptr usedBytes{};
+    std::vector<Slot> slots;
+};
@@ -0,0 +1,398 @@
+#include "keyframe_store.h"
+#include "../../core/config.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // How a ComputeCell field is stored in a delta. quantum == 0 marks an integer field (stored exactly).
+    struct CellFieldCodec
+    {
+        size_t offset;
+        int components;
+        float quantum;
+    };
+
+    // Power of two steps so decoding is exact float math. Positions keep ~0.00024 units of precision,
+    // well below the 0.001 restore tolerance checked by the time scrubber.
+    const CellFieldCodec CELL_FIELDS[] = {
+        { offsetof(ComputeCell, positionAndMass),      4, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, velocity),             4, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, acceleration),         4, 1.0f / 1024.0f },
+        { offsetof(ComputeCell, orientation),          4, 1.0f / 32768.0f },
+        { offsetof(ComputeCell, angularVelocity),      4, 1.0f / 32768.0f },
+        { offsetof(ComputeCell, angularAcceleration),  4, 1.0f / 32768.0f },
+        { offsetof(ComputeCell, signallingSubstances), 4, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, modeIndex),            1, 0.0f },
+        { offsetof(ComputeCell, age),                  1, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, toxins),               1, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, nitrates),             1, 1.0f / 4096.0f },
+        { offsetof(ComputeCell, genomeOffset),         1, 0.0f },
+        { offsetof(ComputeCell, simulationId),         1, 0.0f },
+    };
+    constexpr int CELL_FIELD_COUNT = sizeof(CELL_FIELDS) / sizeof(CELL_FIELDS[0]);
+    static_assert(CELL_FIELD_COUNT <= 32, "Changed-field mask is a 32 bit varint");
+
+    // Largest quantised delta written as a varint; anything larger (or non-finite) is stored as a raw float
+    constexpr double MAX_QUANTISED_DELTA = 1073741824.0; // 2^30
+
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t readVarint(const uint8_t*& in)
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (*in & 0x80)
+        {
+            value |= static_cast<uint64_t>(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= static_cast<uint64_t>(*in++) << shift;
+        return value;
+    }
+
+    uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    int64_t unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+    // Component codes: 0 = raw 4 byte value follows, n > 0 = zigzag(delta) + 1
+    void writeRaw(std::vector<uint8_t>& out, const void* value)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        writeVarint(out, 0);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    // Encodes one component against its previous decoded value and updates that value to what the decoder will see.
+    // Returns false if nothing needs to be written (the change is below the quantisation step).
+    bool encodeComponent(const uint8_t* current, uint8_t* previous, float quantum, std::vector<uint8_t>& scratch)
+    {
+        if (quantum == 0.0f)
+        {
+            int32_t cur, prev;
+            std::memcpy(&cur, current, 4);
+            std::memcpy(&prev, previous, 4);
+            if (cur == prev) return false;
+            writeVarint(scratch, zigzag(static_cast<int64_t>(cur) - prev) + 1);
+            std::memcpy(previous, current, 4);
+            return true;
+        }
+
+        float cur, prev;
+        std::memcpy(&cur, current, 4);
+        std::memcpy(&prev, previous, 4);
+        double steps = std::round((static_cast<double>(cur) - prev) / quantum);
+        if (std::isfinite(cur) && std::isfinite(prev) && std::abs(steps) <= MAX_QUANTISED_DELTA)
+        {
+            if (steps == 0.0) return false;
+            int64_t q = static_cast<int64_t>(steps);
+            writeVarint(scratch, zigzag(q) + 1);
+            float decoded = prev + static_cast<float>(q) * quantum;
+            std::memcpy(previous, &decoded, 4);
+            return true;
+        }
+
+        if (std::memcmp(current, previous, 4) == 0) return false;
+        writeRaw(scratch, current);
+        std::memcpy(previous, current, 4);
+        return true;
+    }
+
+    void decodeComponent(const uint8_t*& in, uint8_t* value, float quantum)
+    {
+        uint64_t code = readVarint(in);
+        if (code == 0)
+        {
+            std::memcpy(value, in, 4);
+            in += 4;
+            return;
+        }
+
+        int64_t q = unzigzag(code - 1);
+        if (quantum == 0.0f)
+        {
+            int32_t prev;
+            std::memcpy(&prev, value, 4);
+            int32_t decoded = static_cast<int32_t>(prev + q);
+            std::memcpy(value, &decoded, 4);
+        }
+        else
+        {
+            float prev;
+            std::memcpy(&prev, value, 4);
+            float decoded = prev + static_cast<float>(q) * quantum;
+            std::memcpy(value, &decoded, 4);
+        }
+    }
+
+    size_t genomeBytes(const GenomeData& genome)
+    {
+        return sizeof(GenomeData) + genome.modes.size() * sizeof(ModeSettings);
+    }
+}
+
+void KeyframeStore::reset(const GenomeData& newGenome)
+{
+    keyframes.clear();
+    lastCells.clear();
+    lastConnections.clear();
+    forceFull = false;
+    genome = newGenome;
+}
+
+int KeyframeStore::append(float time, const std::vector<ComputeCell>& cells, const std::vector<AdhesionConnection>& connections,
+                          const std::vector<uint32_t>& reachedModes)
+{
+    Keyframe keyframe;
+    keyframe.time = time;
+    keyframe.reachedModes = reachedModes;
+    keyframe.cellCount = static_cast<int>(cells.size());
+    keyframe.adhesionCount = static_cast<int>(connections.size());
+    keyframe.isFull = forceFull || keyframes.size() % config::KEYFRAME_FULL_INTERVAL == 0;
+    forceFull = false;
+
+    encodeCells(cells, keyframe.isFull, keyframe.cellData);
+    encodeConnections(connections, keyframe.isFull, keyframe.adhesionData);
+
+    keyframe.isValid = true;
+    keyframes.push_back(std::move(keyframe));
+    return static_cast<int>(keyframes.size()) - 1;
+}
+
+int KeyframeStore::appendGPU(float time, int cellCount, int adhesionCount, int gpuSlot, const std::vector<uint32_t>& reachedModes)
+{
+    Keyframe keyframe;
+    keyframe.time = time;
+    keyframe.reachedModes = reachedModes;
+    keyframe.cellCount = cellCount;
+    keyframe.adhesionCount = adhesionCount;
+    keyframe.gpuSlot = gpuSlot;
+    keyframe.isValid = true;
+    keyframes.push_back(std::move(keyframe));
+
+    // There is no decoded CPU state to take the next delta against
+    lastCells.clear();
+    lastConnections.clear();
+    forceFull = true;
+    return static_cast<int>(keyframes.size()) - 1;
+}
+
+void KeyframeStore::truncate(int count)
+{
+    if (count < 0 || count >= static_cast<int>(keyframes.size()))
+        return;
+    keyframes.resize(count);
+
+    // The next delta has to be taken against the new last keyframe
+    lastCells.clear();
+    lastConnections.clear();
+    forceFull = !restore(count - 1, lastCells, lastConnections);
+}
+
+void KeyframeStore::thin()
+{
+    // Deltas refer to the dropped keyframes, so the kept ones are decoded and appended to a new timeline.
+    // Re-encoding a decoded state can add up to half a quantisation step on top of the original error.
+    KeyframeStore thinned;
+    thinned.reset(genome);
+    std::vector<ComputeCell> cells;
+    std::vector<AdhesionConnection> connections;
+    for (size_t i = 0; i < keyframes.size(); i += 2)
+    {
+        const Keyframe& keyframe = keyframes[i];
+        if (keyframe.gpuSlot >= 0)
+        {
+            thinned.appendGPU(keyframe.time, keyframe.cellCount, keyframe.adhesionCount, keyframe.gpuSlot, keyframe.reachedModes);
+        }
+        else if (restore(static_cast<int>(i), cells, connections))
+        {
+            thinned.append(keyframe.time, cells, connections, keyframe.reachedModes);
+        }
+    }
+    *this = std::move(thinned);
+}
+
+bool KeyframeStore::restore(int index, std::vector<ComputeCell>& cells, std::vector<AdhesionConnection>& connections) const
+{
+    if (index < 0 || index >= static_cast<int>(keyframes.size()) || !keyframes[index].isValid || keyframes[index].gpuSlot >= 0)
+        return false;
+
+    // Walk back to the full keyframe this one depends on, then apply the deltas forward
+    int base = index;
+    while (base > 0 && !keyframes[base].isFull)
+        base--;
+
+    cells.clear();
+    connections.clear();
+    for (int i = base; i <= index; i++)
+    {
+        decodeCells(keyframes[i], cells);
+        decodeConnections(keyframes[i], connections);
+    }
+    return true;
+}
+
+size_t KeyframeStore::getEncodedBytes() const
+{
+    size_t bytes = genomeBytes(genome);
+    for (const Keyframe& keyframe : keyframes)
+    {
+        if (keyframe.gpuSlot >= 0)
+            continue;
+        bytes += sizeof(Keyframe) + keyframe.cellData.capacity() + keyframe.adhesionData.capacity();
+    }
+    return bytes;
+}
+
+size_t KeyframeStore::getUncompressedBytes() const
+{
+    size_t bytes = 0;
+    for (const Keyframe& keyframe : keyframes)
+    {
+        if (keyframe.gpuSlot >= 0)
+            continue;
+        bytes += genomeBytes(genome)
+            + keyframe.cellCount * sizeof(ComputeCell)
+            + keyframe.adhesionCount * sizeof(AdhesionConnection);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// CELL RECORDS
+// ============================================================================
+// Per cell: varint mask of changed fields, then for each changed field one code per component.
+
+void KeyframeStore::encodeCells(const std::vector<ComputeCell>& cells, bool full, std::vector<uint8_t>& out)
+{
+    if (full)
+        lastCells.clear();
+    lastCells.resize(cells.size()); // Appended cells are encoded against a default ComputeCell
+
+    std::vector<uint8_t> scratch;
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        const uint8_t* current = reinterpret_cast<const uint8_t*>(&cells[i]);
+        uint8_t* previous = reinterpret_cast<uint8_t*>(&lastCells[i]);
+
+        uint32_t mask = 0;
+        scratch.clear();
+        for (int f = 0; f < CELL_FIELD_COUNT; f++)
+        {
+            const CellFieldCodec& field = CELL_FIELDS[f];
+            size_t fieldStart = scratch.size();
+            uint8_t saved[16];
+            std::memcpy(saved, previous + field.offset, field.components * 4);
+            bool changed = false;
+            for (int c = 0; c < field.components; c++)
+            {
+                size_t offset = field.offset + c * 4;
+                changed |= encodeComponent(current + offset, previous + offset, field.quantum, scratch);
+            }
+            if (!changed)
+                continue;
+
+            // A changed field writes every component so the decoder knows how many codes to read;
+            // components that did not change are written as a zero delta
+            scratch.resize(fieldStart);
+            std::memcpy(previous + field.offset, saved, field.components * 4);
+            for (int c = 0; c < field.components; c++)
+            {
+                size_t offset = field.offset + c * 4;
+                if (!encodeComponent(current + offset, previous + offset, field.quantum, scratch))
+                    writeVarint(scratch, zigzag(0) + 1);
+            }
+            mask |= 1u << f;
+        }
+
+        writeVarint(out, mask);
+        out.insert(out.end(), scratch.begin(), scratch.end());
+    }
+    out.shrink_to_fit();
+}
+
+void KeyframeStore::decodeCells(const Keyframe& keyframe, std::vector<ComputeCell>& cells)
+{
+    if (keyframe.isFull)
+        cells.clear();
+    cells.resize(keyframe.cellCount);
+
+    const uint8_t* in = keyframe.cellData.data();
+    for (int i = 0; i < keyframe.cellCount; i++)
+    {
+        uint8_t* value = reinterpret_cast<uint8_t*>(&cells[i]);
+        uint32_t mask = static_cast<uint32_t>(readVarint(in));
+        for (int f = 0; f < CELL_FIELD_COUNT; f++)
+        {
+            if (!(mask & (1u << f)))
+                continue;
+            const CellFieldCodec& field = CELL_FIELDS[f];
+            for (int c = 0; c < field.components; c++)
+            {
+                decodeComponent(in, value + field.offset + c * 4, field.quantum);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// ADHESION CONNECTIONS
+// ============================================================================
+// Only connections that differ from the previous keyframe are written, as (index gap, 4 varint fields).
+
+void KeyframeStore::encodeConnections(const std::vector<AdhesionConnection>& connections, bool full, std::vector<uint8_t>& out)
+{
+    if (full)
+        lastConnections.clear();
+    size_t previousCount = lastConnections.size();
+
+    size_t lastIndex = 0;
+    size_t changedCount = 0;
+    std::vector<uint8_t> records;
+    for (size_t i = 0; i < connections.size(); i++)
+    {
+        const AdhesionConnection& connection = connections[i];
+        if (i < previousCount && std::memcmp(&connection, &lastConnections[i], sizeof(AdhesionConnection)) == 0)
+            continue;
+
+        writeVarint(records, i - lastIndex);
+        writeVarint(records, connection.cellAIndex);
+        writeVarint(records, connection.cellBIndex);
+        writeVarint(records, connection.modeIndex);
+        writeVarint(records, connection.isActive);
+        lastIndex = i;
+        changedCount++;
+    }
+
+    writeVarint(out, changedCount);
+    out.insert(out.end(), records.begin(), records.end());
+    out.shrink_to_fit();
+    lastConnections = connections;
+}
+
+void KeyframeStore::decodeConnections(const Keyframe& keyframe, std::vector<AdhesionConnection>& connections)
+{
+    if (keyframe.isFull)
+        connections.clear();
+    connections.resize(keyframe.adhesionCount);
+
+    const uint8_t* in = keyframe.adhesionData.data();
+    size_t changedCount = readVarint(in);
+    size_t index = 0;
+    for (size_t i = 0; i < changedCount; i++)
+    {
+        index += readVarint(in);
+        AdhesionConnection& connection = connections[index];
+        connection.cellAIndex = static_cast<uint32_t>(readVarint(in));
+        connection.cellBIndex = static_cast<uint32_t>(readVarint(in));
+        connection.modeIndex = static_cast<uint32_t>(readVarint(in));
+        connection.isActive = static_cast<uint32_t>(readVarint(in));
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "common_structs.h"
+
+// Compressed storage for the time scrubber keyframes.
+// Keyframes are appended in time order. Every KEYFRAME_FULL_INTERVAL-th keyframe is stored in full,
+// the ones in between only store what changed since the previous keyframe:
+//  - each cell gets a bitmask of the fields that changed, followed by the changed fields only
+//  - float fields are quantised (fixed step per field) and written as zigzag varint deltas
+//  - cells appended since the previous keyframe are encoded against a default ComputeCell
+//  - adhesion connections are written as (index gap, connection) pairs for the entries that changed
+// The genome is shared by all keyframes of a store instead of being copied into each one.
+// Keyframes that live in the GPU KeyframeArena are recorded here as metadata only (gpuSlot >= 0).
+//
+// Deltas are taken against the *decoded* previous keyframe, so quantisation error never accumulates:
+// every restored float is within half a quantisation step of the captured value.
+// Restoring a keyframe decodes forward from the last full keyframe, so it touches at most
+// KEYFRAME_FULL_INTERVAL keyframes no matter how long the timeline is.
+class KeyframeStore
+{
+public:
+    struct Keyframe
+    {
+        float time = 0.0f;
+        int cellCount = 0;
+        int adhesionCount = 0;
+        bool isFull = false;
+        bool isValid = false;
+        int gpuSlot = -1;                   // Slot in the KeyframeArena, or -1 if encoded here
+        std::vector<uint32_t> reachedModes; // Bit per mode that any cell has been in up to this keyframe
+        std::vector<uint8_t> cellData;      // Encoded cell records
+        std::vector<uint8_t> adhesionData;  // Encoded adhesion connection changes
+    };
+
+    // Drops all keyframes and starts a new timeline for this genome
+    void reset(const GenomeData& genome);
+
+    // Appends a keyframe; returns its index
+    int append(float time, const std::vector<ComputeCell>& cells, const std::vector<AdhesionConnection>& connections,
+               const std::vector<uint32_t>& reachedModes);
+    // Appends a keyframe whose data is held in the GPU keyframe arena; the next CPU keyframe is stored in full
+    int appendGPU(float time, int cellCount, int adhesionCount, int gpuSlot, const std::vector<uint32_t>& reachedModes);
+
+    // Drops every keyframe from `count` on, so the timeline can be resimulated from keyframe count - 1
+    void truncate(int count);
+    // Drops every second keyframe (keeping the first), re-encoding the rest. GPU keyframes keep their arena slots.
+    void thin();
+    // Replaces the genome without touching keyframes (for edits that don't affect the kept history)
+    void setGenome(const GenomeData& newGenome) { genome = newGenome; }
+
+    // Decodes keyframe `index` into the output vectors; returns false if the index is out of range or on the GPU
+    bool restore(int index, std::vector<ComputeCell>& cells, std::vector<AdhesionConnection>& connections) const;
+
+    const GenomeData& getGenome() const { return genome; }
+
+    size_t size() const { return keyframes.size(); }
+    bool empty() const { return keyframes.empty(); }
+    const Keyframe& operator[](size_t index) const { return keyframes[index]; }
+
+    // Memory statistics for the CPU-encoded keyframes (encoded bytes vs. uncompressed ComputeCell/AdhesionConnection copies)
+    size_t getEncodedBytes() const;
+    size_t getUncompressedBytes() const;
+
+private:
+    void encodeCells(const std::vector<ComputeCell>& cells, bool full, std::vector<uint8_t>& out);
+    void encodeConnections(const std::vector<AdhesionConnection>& connections, bool full, std::vector<uint8_t>& out);
+    static void decodeCells(const Keyframe& keyframe, std::vector<ComputeCell>& cells);
+    static void decodeConnections(const Keyframe& keyframe, std::vector<AdhesionConnection>& connections);
+
+    std::vector<Keyframe> keyframes;
+    GenomeData genome;
+
+    // Decoded state of the last appended keyframe, which is what the next delta is taken against
+    std::vector<ComputeCell> lastCells;
+    std::vector<AdhesionConnection> lastConnections;
+    bool forceFull = false;
+};
@@ -1,5 +1,4 @@
 #include "cell_manager.h"
-#include "../../rendering/camera/camera.h"
 #include "../../core/config.h"
 #include "../../ui/ui_manager.h"
 #include <iostream>
@@ -28,22 +27,16 @@ void CellManager::initializeLODSystem()
     sphereMesh.setupLODBuffers();
     
     // Create separate instance buffers for each LOD level
-    glCreateBuffers(4, lodInstanceBuffers);
     for (int i = 0; i < 4; i++) {
-        glNamedBufferStorage(
-            lodInstanceBuffers[i],
-            cellLimit * sizeof(float) * 12, // 3 vec4s per instance (positionAndRadius, color, orientation)
-            nullptr,
+        lodInstanceBuffers[i] = bufferArena.createBuffer(GPUSubsystem::Instances,
+            cellCapacity * sizeof(float) * 12, // 3 vec4s per instance (positionAndRadius, color, orientation)
             GL_DYNAMIC_STORAGE_BIT
         );
     }
     
     // Create LOD count buffer
-    glCreateBuffers(1, &lodCountBuffer);
-    glNamedBufferStorage(
-        lodCountBuffer,
+    lodCountBuffer = bufferArena.createBuffer(GPUSubsystem::Instances,
         4 * sizeof(uint32_t), // 4 LOD levels
-        nullptr,
         GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT
     );
     
@@ -62,20 +55,14 @@ void CellManager::cleanupLODSystem()
     
     // Cleanup LOD instance buffers
     for (int i = 0; i < 4; i++) {
-        if (lodInstanceBuffers[i] != 0) {
-            glDeleteBuffers(1, &lodInstanceBuffers[i]);
-            lodInstanceBuffers[i] = 0;
-        }
+        bufferArena.destroyBuffer(lodInstanceBuffers[i]);
     }
     
     // Cleanup LOD count buffer
-    if (lodCountBuffer != 0) {
-        glDeleteBuffers(1, &lodCountBuffer);
-        lodCountBuffer = 0;
-    }
+    bufferArena.destroyBuffer(lodCountBuffer);
 }
 
-void CellManager::runLODCompute(const Camera& camera)
+void CellManager::runLODCompute()
 {
     if (cellCount == 0) return;
     
@@ -87,12 +74,7 @@ void CellManager::runLODCompute(const Camera& camera)
     uint32_t zeroCounts[4] = {0, 0, 0, 0};
     glNamedBufferSubData(lodCountBuffer, 0, sizeof(zeroCounts), zeroCounts);
     
-    // Set uniforms
-    lodComputeShader->setVec3("u_cameraPos", camera.getPosition());
-    lodComputeShader->setFloat("u_lodDistances[0]", lodDistances[0]);
-    lodComputeShader->setFloat("u_lodDistances[1]", lodDistances[1]);
-    lodComputeShader->setFloat("u_lodDistances[2]", lodDistances[2]);
-    lodComputeShader->setFloat("u_lodDistances[3]", lodDistances[3]);
+    // Camera position and LOD thresholds come from the FrameConstants block
     
     // Bind buffers
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
@@ -111,18 +93,19 @@ void CellManager::runLODCompute(const Camera& camera)
     addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     
     // Read back LOD counts for rendering
-    glGetNamedBufferSubData(lodCountBuffer, 0, sizeof(lodInstanceCounts), lodInstanceCounts);
+    glGetNamedBufferSubData(lodCountBuffer, 0, sizeof(int) * SphereMesh::LOD_LEVELS, lodInstanceCounts);
+    lodInstanceCounts[IMPOSTOR_LOD_LEVEL] = 0; // The legacy LOD path has no impostor level
     
     // Invalidate cache since LOD counts have changed
     invalidateStatisticsCache();
 }
 
-void CellManager::updateLODLevels(const Camera& camera)
+void CellManager::updateLODLevels()
 {
     if (!useLODSystem || cellCount == 0) return;
     
-    // Use unified culling system for all cases
-    runUnifiedCulling(camera);
+    // Use unified culling system for all cases (uses the frame constants of the last updateFrameConstants call)
+    runUnifiedCulling();
     
     flushBarriers();
 }
@@ -150,6 +133,9 @@ int CellManager::getTotalTriangleCount() const {
             int visibleTriangles = icosphereTriangles[lod] / 2;
             totalTriangles += visibleTriangles * lodInstanceCounts[lod];
         }
+        
+        // Impostors are a single camera-facing quad (2 triangles) per cell
+        totalTriangles += 2 * lodInstanceCounts[IMPOSTOR_LOD_LEVEL];
     } else {
         // Fallback to old calculation for non-culling rendering
         // Legacy system uses latitude/longitude sphere: 8x12 segments = 96 triangles
@@ -180,6 +166,9 @@ int CellManager::getTotalVertexCount() const {
         for (int lod = 0; lod < 4; lod++) {
             totalVertices += icosphereVertices[lod] * lodInstanceCounts[lod];
         }
+        
+        // Impostor quads are a 4 vertex triangle strip
+        totalVertices += 4 * lodInstanceCounts[IMPOSTOR_LOD_LEVEL];
     } else {
         // Fallback to old calculation for non-culling rendering
         // Legacy system uses latitude/longitude sphere: (8+1) * (12+1) = 9 * 13 = 117 vertices
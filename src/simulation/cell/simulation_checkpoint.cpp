@@ -0,0 +1,462 @@
+#include "simulation_checkpoint.h"
+#include "cell_manager.h"
+#include "../../core/config.h"
+#include "../../utils/mapped_file.h"
+#include "../../utils/timer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    uint64_t alignSection(uint64_t offset)
+    {
+        return (offset + CHECKPOINT_SECTION_ALIGNMENT - 1) & ~(CHECKPOINT_SECTION_ALIGNMENT - 1);
+    }
+
+    // ------------------------------------------------------------------------
+    // Genome serialisation (names are variable length, so the genome isn't a flat copy)
+    // ------------------------------------------------------------------------
+
+    template <typename T>
+    void writeValue(std::vector<uint8_t>& out, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeString(std::vector<uint8_t>& out, const std::string& value)
+    {
+        writeValue(out, static_cast<uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    struct ByteReader
+    {
+        const uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        bool ok = true;
+
+        template <typename T>
+        void read(T& value)
+        {
+            if (!ok || size - position < sizeof(T)) { ok = false; return; }
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+        }
+
+        void readString(std::string& value)
+        {
+            uint32_t length = 0;
+            read(length);
+            if (!ok || size - position < length) { ok = false; return; }
+            value.assign(reinterpret_cast<const char*>(data + position), length);
+            position += length;
+        }
+    };
+
+    void writeChild(std::vector<uint8_t>& out, const ChildSettings& child)
+    {
+        writeValue(out, child.modeNumber);
+        writeValue(out, child.orientation);
+        writeValue(out, static_cast<uint8_t>(child.keepAdhesion));
+    }
+
+    void readChild(ByteReader& in, ChildSettings& child)
+    {
+        uint8_t keepAdhesion = 0;
+        in.read(child.modeNumber);
+        in.read(child.orientation);
+        in.read(keepAdhesion);
+        child.keepAdhesion = keepAdhesion != 0;
+    }
+
+    void serializeGenome(std::vector<uint8_t>& out, const GenomeData& genome)
+    {
+        writeString(out, genome.name);
+        writeValue(out, genome.initialMode);
+        writeValue(out, genome.initialOrientation);
+        writeValue(out, static_cast<uint32_t>(genome.modes.size()));
+
+        for (const ModeSettings& mode : genome.modes)
+        {
+            writeString(out, mode.name);
+            writeValue(out, mode.color);
+            writeValue(out, static_cast<uint8_t>(mode.parentMakeAdhesion));
+            writeValue(out, mode.splitMass);
+            writeValue(out, mode.splitInterval);
+            writeValue(out, mode.parentSplitDirection);
+            writeChild(out, mode.childA);
+            writeChild(out, mode.childB);
+#define CHECKPOINT_WRITE_FIELD(cppType, glslType, name, init) writeValue(out, mode.adhesionSettings.name);
+#define CHECKPOINT_WRITE_ARRAY(cppType, glslType, name, count) writeValue(out, mode.adhesionSettings.name);
+            ADHESION_SETTINGS_FIELDS(CHECKPOINT_WRITE_FIELD, CHECKPOINT_WRITE_ARRAY)
+#undef CHECKPOINT_WRITE_FIELD
+#undef CHECKPOINT_WRITE_ARRAY
+        }
+    }
+
+    bool deserializeGenome(ByteReader& in, GenomeData& genome)
+    {
+        uint32_t modeCount = 0;
+        in.readString(genome.name);
+        in.read(genome.initialMode);
+        in.read(genome.initialOrientation);
+        in.read(modeCount);
+        if (!in.ok || modeCount == 0 || modeCount > in.size - in.position) // Every mode takes more than a byte, so this bounds the allocation
+        {
+            return false;
+        }
+
+        genome.modes.assign(modeCount, ModeSettings());
+        for (ModeSettings& mode : genome.modes)
+        {
+            uint8_t parentMakeAdhesion = 0;
+            in.readString(mode.name);
+            in.read(mode.color);
+            in.read(parentMakeAdhesion);
+            in.read(mode.splitMass);
+            in.read(mode.splitInterval);
+            in.read(mode.parentSplitDirection);
+            readChild(in, mode.childA);
+            readChild(in, mode.childB);
+#define CHECKPOINT_READ_FIELD(cppType, glslType, name, init) in.read(mode.adhesionSettings.name);
+#define CHECKPOINT_READ_ARRAY(cppType, glslType, name, count) in.read(mode.adhesionSettings.name);
+            ADHESION_SETTINGS_FIELDS(CHECKPOINT_READ_FIELD, CHECKPOINT_READ_ARRAY)
+#undef CHECKPOINT_READ_FIELD
+#undef CHECKPOINT_READ_ARRAY
+            mode.parentMakeAdhesion = parentMakeAdhesion != 0;
+        }
+        return in.ok;
+    }
+
+    // The genome table keeps each genome's slots, because cells in the file point at them
+    std::vector<uint8_t> serializeGenomeTable(const GenomeTable& table)
+    {
+        std::vector<uint8_t> out;
+        writeValue(out, static_cast<uint32_t>(table.getGenomeCount()));
+        for (int id = 0; id < table.getGenomeCount(); id++)
+        {
+            writeValue(out, static_cast<int32_t>(table[id].modeOffset));
+            writeValue(out, static_cast<int32_t>(table[id].modeCapacity));
+            serializeGenome(out, table[id].genome);
+        }
+        return out;
+    }
+
+    bool deserializeGenomeTable(const uint8_t* data, size_t size, std::vector<GenomeTable::Entry>& entries)
+    {
+        ByteReader in{ data, size };
+        uint32_t genomeCount = 0;
+        in.read(genomeCount);
+        if (!in.ok || genomeCount == 0 || genomeCount > size)
+        {
+            return false;
+        }
+
+        entries.assign(genomeCount, GenomeTable::Entry());
+        for (GenomeTable::Entry& entry : entries)
+        {
+            int32_t modeOffset = 0;
+            int32_t modeCapacity = 0;
+            in.read(modeOffset);
+            in.read(modeCapacity);
+            if (!in.ok || !deserializeGenome(in, entry.genome))
+            {
+                return false;
+            }
+            entry.modeOffset = modeOffset;
+            entry.modeCapacity = modeCapacity;
+        }
+        return in.ok;
+    }
+
+    // ------------------------------------------------------------------------
+    // Streaming GPU -> file copies
+    // ------------------------------------------------------------------------
+
+    void padTo(std::ofstream& file, uint64_t offset)
+    {
+        static const char zeros[CHECKPOINT_SECTION_ALIGNMENT]{};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        if (offset > position)
+        {
+            file.write(zeros, static_cast<std::streamsize>(offset - position));
+        }
+    }
+
+    // Copies `size` bytes of a GPU buffer into the file through a persistently mapped staging buffer,
+    // one chunk at a time, waiting on a fence for each chunk instead of stalling the whole pipeline.
+    void streamBufferToFile(std::ofstream& file, GLuint source, uint64_t size, GLuint staging, const uint8_t* stagingPtr, GLsizeiptr chunkSize)
+    {
+        for (uint64_t offset = 0; offset < size; offset += chunkSize)
+        {
+            GLsizeiptr bytes = static_cast<GLsizeiptr>(std::min<uint64_t>(chunkSize, size - offset));
+            glCopyNamedBufferSubData(source, staging, static_cast<GLintptr>(offset), 0, bytes);
+
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+
+            file.write(reinterpret_cast<const char*>(stagingPtr), bytes);
+        }
+    }
+}
+
+bool saveCheckpoint(const std::string& path, CellManager& cellManager, double simulationTime)
+{
+    TimerCPU cpuTimer("Save Checkpoint");
+
+    // Finish the last simulation step before reading its buffers
+    cellManager.addBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    cellManager.flushBarriers();
+
+    const GenomeTable& genomeTable = cellManager.genomeTable;
+    if (genomeTable.empty())
+    {
+        std::cout << "Error: cannot save a checkpoint without a genome\n";
+        return false;
+    }
+    std::vector<uint8_t> genomeBytes = serializeGenomeTable(genomeTable);
+    std::vector<GPUMode> gpuModes = genomeTable.buildGPUModes();
+    std::vector<uint32_t> reachedModes = cellManager.getReachedModes(genomeTable.getModeCount());
+
+    // Exact counts, the regular ones can be a few ticks old
+    cellManager.updateCounts(true);
+
+    CheckpointHeader header;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.cellCount = cellManager.getCellCount();
+    header.adhesionCount = cellManager.adhesionCount;
+    header.modeCount = static_cast<int32_t>(gpuModes.size());
+    header.cellLimit = cellManager.getCellLimit();
+    header.bufferRotation = cellManager.bufferRotation;
+    header.simulationTime = simulationTime;
+
+    const uint64_t sectionSizes[CHECKPOINT_SECTION_COUNT] = {
+        genomeBytes.size(),
+        gpuModes.size() * sizeof(GPUMode),
+        static_cast<uint64_t>(header.cellCount) * sizeof(ComputeCell),
+        static_cast<uint64_t>(header.adhesionCount) * sizeof(AdhesionConnection),
+        reachedModes.size() * sizeof(uint32_t)
+    };
+    uint64_t offset = sizeof(CheckpointHeader);
+    for (uint32_t i = 0; i < CHECKPOINT_SECTION_COUNT; i++)
+    {
+        offset = alignSection(offset);
+        header.sections[i].offset = offset;
+        header.sections[i].size = sectionSizes[i];
+        offset += sectionSizes[i];
+    }
+
+    std::filesystem::path filePath(path);
+    if (filePath.has_parent_path())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(filePath.parent_path(), error);
+    }
+
+    // Written to a temporary file first so a failed save never destroys the previous checkpoint
+    std::filesystem::path tempPath = filePath;
+    tempPath += ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: could not open checkpoint file " << tempPath.string() << " for writing\n";
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(file, header.sections[CHECKPOINT_SECTION_GENOME].offset);
+    file.write(reinterpret_cast<const char*>(genomeBytes.data()), genomeBytes.size());
+    padTo(file, header.sections[CHECKPOINT_SECTION_MODES].offset);
+    file.write(reinterpret_cast<const char*>(gpuModes.data()), gpuModes.size() * sizeof(GPUMode));
+
+    // Cells and adhesions go GPU -> staging -> file in chunks
+    const uint64_t largestSection = std::max(sectionSizes[CHECKPOINT_SECTION_CELLS], sectionSizes[CHECKPOINT_SECTION_ADHESIONS]);
+    GLsizeiptr chunkSize = static_cast<GLsizeiptr>(std::min<uint64_t>(config::CHECKPOINT_CHUNK_BYTES, std::max<uint64_t>(largestSection, 1)));
+    ReadbackBuffer staging = cellManager.readbackPool.acquire(chunkSize);
+    if (!staging.isValid())
+    {
+        std::cout << "Error: could not get a checkpoint staging buffer\n";
+        file.close();
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    padTo(file, header.sections[CHECKPOINT_SECTION_CELLS].offset);
+    streamBufferToFile(file, cellManager.getCellReadBuffer(), sectionSizes[CHECKPOINT_SECTION_CELLS], staging.buffer, staging.mapped, chunkSize);
+    padTo(file, header.sections[CHECKPOINT_SECTION_ADHESIONS].offset);
+    streamBufferToFile(file, cellManager.adhesionConnectionBuffer, sectionSizes[CHECKPOINT_SECTION_ADHESIONS], staging.buffer, staging.mapped, chunkSize);
+
+    cellManager.readbackPool.recycle(staging);
+
+    padTo(file, header.sections[CHECKPOINT_SECTION_REACHED_MODES].offset);
+    file.write(reinterpret_cast<const char*>(reachedModes.data()), reachedModes.size() * sizeof(uint32_t));
+
+    file.close();
+    std::error_code error;
+    if (!file)
+    {
+        std::cout << "Error: failed writing checkpoint " << tempPath.string() << "\n";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error)
+    {
+        std::cout << "Error: could not replace checkpoint " << path << " (" << error.message() << ")\n";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::cout << "Saved checkpoint " << path << ": " << header.cellCount << " cells, "
+        << header.adhesionCount << " adhesions at t=" << simulationTime << "s\n";
+    return true;
+}
+
+bool loadCheckpoint(const std::string& path, CellManager& cellManager, GenomeData& genome, double& simulationTime)
+{
+    TimerCPU cpuTimer("Load Checkpoint");
+
+    MappedFile file;
+    if (!file.open(path))
+    {
+        std::cout << "Error: could not open checkpoint " << path << "\n";
+        return false;
+    }
+
+    // Validate everything before touching the simulation
+    CheckpointHeader header;
+    if (file.size() < sizeof(CheckpointHeader))
+    {
+        std::cout << "Error: " << path << " is not a checkpoint (file too small)\n";
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(CheckpointHeader));
+    if (header.magic != CHECKPOINT_MAGIC)
+    {
+        std::cout << "Error: " << path << " is not a checkpoint\n";
+        return false;
+    }
+    if (header.version != CHECKPOINT_VERSION || header.headerSize < sizeof(CheckpointHeader) ||
+        header.sectionCount < CHECKPOINT_SECTION_COUNT)
+    {
+        std::cout << "Error: checkpoint " << path << " has unsupported version " << header.version << "\n";
+        return false;
+    }
+    if (header.cellStride != sizeof(ComputeCell) || header.adhesionStride != sizeof(AdhesionConnection) ||
+        header.modeStride != sizeof(GPUMode))
+    {
+        std::cout << "Error: checkpoint " << path << " was written with different GPU struct layouts\n";
+        return false;
+    }
+
+    const uint64_t expectedSizes[CHECKPOINT_SECTION_COUNT] = {
+        header.sections[CHECKPOINT_SECTION_GENOME].size,
+        static_cast<uint64_t>(header.modeCount) * sizeof(GPUMode),
+        static_cast<uint64_t>(header.cellCount) * sizeof(ComputeCell),
+        static_cast<uint64_t>(header.adhesionCount) * sizeof(AdhesionConnection),
+        static_cast<uint64_t>((header.modeCount + 31) / 32) * sizeof(uint32_t)
+    };
+    for (uint32_t i = 0; i < CHECKPOINT_SECTION_COUNT; i++)
+    {
+        const CheckpointHeader::SectionEntry& section = header.sections[i];
+        if (header.cellCount < 0 || header.adhesionCount < 0 || header.modeCount <= 0 ||
+            section.size != expectedSizes[i] || section.offset > file.size() || section.size > file.size() - section.offset)
+        {
+            std::cout << "Error: checkpoint " << path << " is truncated or corrupt\n";
+            return false;
+        }
+    }
+    // The adhesion connection buffer is sized like the cell buffers, so the cell limit bounds both
+    if (header.cellCount > cellManager.getCellLimit() || header.adhesionCount > cellManager.getCellLimit() * config::ADHESIONS_PER_CELL)
+    {
+        std::cout << "Error: checkpoint " << path << " holds " << header.cellCount << " cells and " << header.adhesionCount
+            << " adhesions, more than the cell limit of " << cellManager.getCellLimit() << " allows\n";
+        return false;
+    }
+
+    std::vector<GenomeTable::Entry> genomeEntries;
+    GenomeTable loadedTable;
+    const CheckpointHeader::SectionEntry& genomeSection = header.sections[CHECKPOINT_SECTION_GENOME];
+    if (!deserializeGenomeTable(file.data() + genomeSection.offset, genomeSection.size, genomeEntries) ||
+        !loadedTable.assign(std::move(genomeEntries)) || loadedTable.getModeCount() != header.modeCount)
+    {
+        std::cout << "Error: checkpoint " << path << " has a corrupt genome table\n";
+        return false;
+    }
+
+    // Grown before the reset, so a refusal leaves the current simulation alone
+    if (!cellManager.ensureModeCapacity(header.modeCount))
+    {
+        std::cout << "Error: not enough GPU memory for the " << header.modeCount << " modes of checkpoint " << path << "\n";
+        return false;
+    }
+
+    // One temporary buffer spanning cells and adhesions, allocated before the reset so a refusal leaves the simulation alone
+    const CheckpointHeader::SectionEntry& cells = header.sections[CHECKPOINT_SECTION_CELLS];
+    const CheckpointHeader::SectionEntry& adhesions = header.sections[CHECKPOINT_SECTION_ADHESIONS];
+    uint64_t uploadStart = cells.offset;
+    uint64_t uploadEnd = std::max(cells.offset + cells.size, adhesions.offset + adhesions.size);
+    GLuint upload = cellManager.bufferArena.createBuffer(GPUSubsystem::Upload, static_cast<GLsizeiptr>(std::max<uint64_t>(uploadEnd - uploadStart, 1)),
+                                                         0, file.data() + uploadStart);
+    if (upload == 0)
+    {
+        std::cout << "Error: not enough GPU memory to upload checkpoint " << path << "\n";
+        return false;
+    }
+
+    // The cell buffers are the largest allocation and the reset shrinks them, so make sure they can grow back first
+    int adhesionCells = (header.adhesionCount + config::ADHESIONS_PER_CELL - 1) / config::ADHESIONS_PER_CELL;
+    if (!cellManager.fitsCellsAfterReset(std::max(header.cellCount, adhesionCells)))
+    {
+        std::cout << "Error: not enough GPU memory for the " << header.cellCount << " cells of checkpoint " << path << "\n";
+        cellManager.bufferArena.destroyBuffer(upload);
+        return false;
+    }
+
+    // Cells, adhesions and the mode table are uploaded straight from the mapping
+    cellManager.resetSimulation();
+
+    cellManager.genomeTable = loadedTable;
+    const CheckpointHeader::SectionEntry& modes = header.sections[CHECKPOINT_SECTION_MODES];
+    glNamedBufferSubData(cellManager.modeBuffer, 0, modes.size, file.data() + modes.offset);
+
+    // Then the same GPU copy path keyframes use; the driver can still refuse the memory the budget allowed
+    bool restored = cellManager.restoreStateFromBuffers(upload, 0, header.cellCount,
+                                                        upload, static_cast<GLintptr>(adhesions.offset - uploadStart), header.adhesionCount);
+    cellManager.bufferArena.destroyBuffer(upload);
+    if (!restored)
+    {
+        std::cout << "Error: could not restore the cells of checkpoint " << path << "\n";
+        return false;
+    }
+
+    // All three cell buffers now hold the same data, so the rotation only matters for replaying the exact same sequence
+    cellManager.bufferRotation = ((header.bufferRotation % 3) + 3) % 3;
+
+    const CheckpointHeader::SectionEntry& reached = header.sections[CHECKPOINT_SECTION_REACHED_MODES];
+    std::vector<uint32_t> reachedModes(reached.size / sizeof(uint32_t));
+    std::memcpy(reachedModes.data(), file.data() + reached.offset, reached.size);
+    cellManager.setReachedModes(reachedModes);
+
+    if (cellManager.getCellCount() > 0)
+    {
+        cellManager.updateSpatialGrid();
+    }
+
+    genome = loadedTable[0].genome;
+    simulationTime = header.simulationTime;
+
+    std::cout << "Loaded checkpoint " << path << ": " << header.cellCount << " cells, "
+        << header.adhesionCount << " adhesions at t=" << simulationTime << "s\n";
+    return true;
+}
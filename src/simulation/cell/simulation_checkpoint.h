@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "common_structs.h"
+
+struct CellManager;
+
+// Versioned binary checkpoint of a whole simulation, so long runs can be saved and resumed.
+//
+// File layout (little endian, every section starts on a CHECKPOINT_SECTION_ALIGNMENT boundary):
+//   CheckpointHeader      magic, version, counts, buffer rotation, simulation time and the section table
+//   Genome section        genome table: every genome (editable form) with the mode slots it occupies
+//   Mode table section    GPUMode array exactly as it sits in the mode buffer (all genomes)
+//   Cell section          cellCount ComputeCells, read buffer order
+//   Adhesion section      adhesionCount AdhesionConnections
+//   Reached modes section bitfield of modes reached so far (keyframe invalidation)
+//
+// Saving streams the GPU buffers to disk in CHECKPOINT_CHUNK_BYTES pieces through a small staging buffer,
+// so a 100k cell simulation never needs a second full copy in RAM. Loading memory-maps the file and
+// uploads the mode table, cells and adhesions straight from the mapping without parsing them.
+// Randomness in the simulation is hashed from cell indices on the GPU, so the cell buffers and
+// buffer rotation are all the state needed to continue a run deterministically.
+constexpr uint32_t CHECKPOINT_MAGIC = 0x50435342; // "BSCP"
+constexpr uint32_t CHECKPOINT_VERSION = 2; // 2: genome table instead of a single genome
+constexpr uint64_t CHECKPOINT_SECTION_ALIGNMENT = 256;
+
+enum CheckpointSection : uint32_t
+{
+    CHECKPOINT_SECTION_GENOME = 0,
+    CHECKPOINT_SECTION_MODES,
+    CHECKPOINT_SECTION_CELLS,
+    CHECKPOINT_SECTION_ADHESIONS,
+    CHECKPOINT_SECTION_REACHED_MODES,
+    CHECKPOINT_SECTION_COUNT
+};
+
+struct CheckpointHeader
+{
+    struct SectionEntry
+    {
+        uint64_t offset = 0; // From the start of the file
+        uint64_t size = 0;   // In bytes
+    };
+
+    uint32_t magic = CHECKPOINT_MAGIC;
+    uint32_t version = CHECKPOINT_VERSION;
+    uint32_t headerSize = 0;        // sizeof(CheckpointHeader) when written, lets newer versions append fields
+    uint32_t sectionCount = CHECKPOINT_SECTION_COUNT;
+    uint32_t cellStride = sizeof(ComputeCell);
+    uint32_t adhesionStride = sizeof(AdhesionConnection);
+    uint32_t modeStride = sizeof(GPUMode);
+    int32_t cellCount = 0;
+    int32_t adhesionCount = 0;
+    int32_t modeCount = 0;
+    int32_t cellLimit = 0;          // Limit of the saved simulation (informational, loading only needs cellCount to fit)
+    int32_t bufferRotation = 0;
+    double simulationTime = 0.0;
+    SectionEntry sections[CHECKPOINT_SECTION_COUNT];
+};
+
+static_assert(sizeof(CheckpointHeader) == 136, "CheckpointHeader layout is part of the file format");
+
+// Writes the current state of cellManager, including every genome in its genome table;
+// returns false and prints the reason on failure
+bool saveCheckpoint(const std::string& path, CellManager& cellManager, double simulationTime);
+
+// Replaces the state of cellManager with a checkpoint and sets genome to its first genome;
+// leaves both untouched on failure
+bool loadCheckpoint(const std::string& path, CellManager& cellManager, GenomeData& genome, double& simulationTime);
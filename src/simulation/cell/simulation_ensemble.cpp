@@ -0,0 +1,166 @@
+#include "simulation_ensemble.h"
+#include "cell_manager.h"
+#include "../../core/config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+const char* getEnsembleParameterName(EnsembleParameter parameter)
+{
+    switch (parameter)
+    {
+    case EnsembleParameter::SplitInterval:      return "Split Interval";
+    case EnsembleParameter::SplitPitch:         return "Split Pitch";
+    case EnsembleParameter::SplitYaw:           return "Split Yaw";
+    case EnsembleParameter::AdhesionRestLength: return "Adhesion Rest Length";
+    case EnsembleParameter::AdhesionStiffness:  return "Adhesion Stiffness";
+    case EnsembleParameter::AdhesionBreakForce: return "Adhesion Break Force";
+    default:                                    return "Unknown";
+    }
+}
+
+std::vector<GenomeData> SimulationEnsemble::makeSweep(const GenomeData& base, const Sweep& sweep, int count, std::vector<float>* values)
+{
+    std::vector<GenomeData> variants(std::max(count, 1), base);
+    if (values) values->assign(variants.size(), 0.0f);
+    if (sweep.modeIndex < 0 || sweep.modeIndex >= static_cast<int>(base.modes.size()))
+    {
+        std::cout << "Warning: sweep mode " << sweep.modeIndex << " does not exist, running identical variants\n";
+        return variants;
+    }
+
+    for (size_t i = 0; i < variants.size(); ++i)
+    {
+        float t = variants.size() > 1 ? static_cast<float>(i) / static_cast<float>(variants.size() - 1) : 0.0f;
+        float value = sweep.from + (sweep.to - sweep.from) * t;
+        ModeSettings& mode = variants[i].modes[sweep.modeIndex];
+        switch (sweep.parameter)
+        {
+        case EnsembleParameter::SplitInterval:      mode.splitInterval = std::max(value, config::physicsTimeStep); break;
+        case EnsembleParameter::SplitPitch:         mode.parentSplitDirection.x = value; break;
+        case EnsembleParameter::SplitYaw:           mode.parentSplitDirection.y = value; break;
+        case EnsembleParameter::AdhesionRestLength: mode.adhesionSettings.restLength = value; break;
+        case EnsembleParameter::AdhesionStiffness:  mode.adhesionSettings.linearSpringStiffness = value; break;
+        case EnsembleParameter::AdhesionBreakForce: mode.adhesionSettings.breakForce = value; break;
+        default: break;
+        }
+        if (values) (*values)[i] = value;
+    }
+    return variants;
+}
+
+bool SimulationEnsemble::start(CellManager& cellManager, const std::vector<GenomeData>& variants)
+{
+    clear();
+    int count = static_cast<int>(variants.size());
+    if (count == 0) return false;
+
+    int share = cellManager.getCellLimit() / count;
+    if (share < 1)
+    {
+        std::cout << "Error: " << count << " simulations don't fit in " << cellManager.getCellLimit() << " cells\n";
+        return false;
+    }
+
+    // Make room for every variant's modes first, so running out of memory leaves the current simulation alone
+    int modeCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        modeCount += static_cast<int>(variants[i].modes.size());
+    }
+    if (!cellManager.ensureModeCapacity(modeCount))
+    {
+        std::cout << "Error: the mode table has no room for " << count << " variants\n";
+        return false;
+    }
+
+    simulationCount = count;
+    cellsPerSimulation = share;
+    latticeSide = std::max(1, static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count)) - 1e-6)));
+
+    cellManager.resetSimulation();
+    cellManager.configureEnsemble(count, share, latticeSide);
+
+    // Every variant becomes its own genome in the mode table
+    for (int i = 0; i < count; ++i)
+    {
+        const GenomeData& variant = variants[i];
+        int genomeId = cellManager.addGenome(variant);
+        if (genomeId < 0)
+        {
+            cellManager.resetSimulation(); // Not expected after the check above; leaves an empty single simulation
+            clear();
+            return false;
+        }
+        int genomeOffset = cellManager.genomeTable.getModeOffset(genomeId);
+
+        ComputeCell root{};
+        root.positionAndMass = glm::vec4(getSimulationOrigin(i), 1.0f);
+        root.orientation = variant.initialOrientation;
+        root.modeIndex = variant.initialMode;
+        root.genomeOffset = genomeOffset;
+        root.simulationId = i;
+        cellManager.addCellToStagingBuffer(root);
+    }
+    cellManager.addStagedCellsToQueueBuffer(); // Force immediate GPU buffer sync
+    cellManager.setSimulationCellCounts(std::vector<uint32_t>(count, 1u));
+
+    // Advance one step so the root cells are in the read buffer (same as Reset Main)
+    cellManager.updateCells(config::physicsTimeStep);
+
+    cellCounts.assign(count, 1.0f);
+    return true;
+}
+
+bool SimulationEnsemble::startSweep(CellManager& cellManager, const GenomeData& base, const Sweep& sweep, int count)
+{
+    std::vector<float> values;
+    std::vector<GenomeData> variants = makeSweep(base, sweep, count, &values);
+    if (!start(cellManager, variants)) return false;
+    sweepValues = std::move(values);
+    return true;
+}
+
+void SimulationEnsemble::clear()
+{
+    simulationCount = 0;
+    cellsPerSimulation = 0;
+    latticeSide = 1;
+    sweepValues.clear();
+    cellCounts.clear();
+}
+
+void SimulationEnsemble::reattach(CellManager& cellManager) const
+{
+    if (!isActive()) return;
+    cellManager.configureEnsemble(simulationCount, cellsPerSimulation, latticeSide);
+    std::vector<uint32_t> counts(cellCounts.begin(), cellCounts.end());
+    cellManager.setSimulationCellCounts(counts);
+}
+
+void SimulationEnsemble::refreshCellCounts(const CellManager& cellManager)
+{
+    if (!isActive()) return;
+    std::vector<uint32_t> counts = cellManager.getSimulationCellCounts();
+    cellCounts.assign(counts.begin(), counts.end());
+}
+
+glm::vec3 SimulationEnsemble::getSimulationOrigin(int index) const
+{
+    // Row-major lattice of latticeSide^3 blocks from the world's low corner, aligned to the spatial grid
+    float spacing = getBlockSize();
+    int x = index % latticeSide;
+    int y = (index / latticeSide) % latticeSide;
+    int z = index / (latticeSide * latticeSide);
+    return glm::vec3(
+        -config::WORLD_SIZE * 0.5f + (x + 0.5f) * spacing,
+        -config::WORLD_SIZE * 0.5f + (y + 0.5f) * spacing,
+        -config::WORLD_SIZE * 0.5f + (z + 0.5f) * spacing);
+}
+
+float SimulationEnsemble::getBlockSize() const
+{
+    // Whole grid cells per block, so a block boundary is always a grid cell boundary
+    return static_cast<float>(config::GRID_RESOLUTION / latticeSide) * config::GRID_CELL_SIZE;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "common_structs.h"
+
+struct CellManager;
+
+// Runs many independent simulations of genome variants side by side in one CellManager.
+// Every variant is added to the CellManager's genome table (cells carry its genomeOffset),
+// each simulation grows from its own root cell in its own block of a lattice over the world, and the
+// shaders keep the simulations apart. Blocks are whole runs of spatial grid cells and every cell is
+// confined to its block, so no grid cell (and none of its MAX_CELLS_PER_GRID slots) is ever shared
+// between simulations. Physics also skips pairs with different simulationIds, and splits stop once
+// a simulation reaches its share of the cell buffer. One dispatch per pass then
+// advances every simulation, instead of K small simulations each paying the per-pass overhead.
+enum class EnsembleParameter
+{
+    SplitInterval,
+    SplitPitch,
+    SplitYaw,
+    AdhesionRestLength,
+    AdhesionStiffness,
+    AdhesionBreakForce,
+    Count
+};
+
+const char* getEnsembleParameterName(EnsembleParameter parameter);
+
+class SimulationEnsemble
+{
+public:
+    struct Sweep
+    {
+        int modeIndex = 0;                                   // Mode whose parameter is varied
+        EnsembleParameter parameter = EnsembleParameter::SplitInterval;
+        float from = 2.0f;
+        float to = 10.0f;
+    };
+
+    // K copies of the base genome with the sweep parameter spread linearly over [from, to]
+    static std::vector<GenomeData> makeSweep(const GenomeData& base, const Sweep& sweep, int count, std::vector<float>* values = nullptr);
+
+    // Resets the cell manager and starts one simulation per variant; returns false if the variants don't fit
+    bool start(CellManager& cellManager, const std::vector<GenomeData>& variants);
+    // Convenience for the UI: makeSweep + start
+    bool startSweep(CellManager& cellManager, const GenomeData& base, const Sweep& sweep, int count);
+    // Forgets the ensemble (the cell manager is left as is, resetSimulation returns it to a single simulation)
+    void clear();
+    // Sets the ensemble up again on a cell manager reloaded from a checkpoint (checkpoints don't store it).
+    // The per-simulation counters come from the last refreshCellCounts.
+    void reattach(CellManager& cellManager) const;
+
+    bool isActive() const { return simulationCount > 0; }
+    int getSimulationCount() const { return simulationCount; }
+    int getCellsPerSimulation() const { return cellsPerSimulation; }
+    const std::vector<float>& getSweepValues() const { return sweepValues; }
+
+    // Reads the per-simulation cell counters back (small synchronous readback, call every few frames)
+    void refreshCellCounts(const CellManager& cellManager);
+    const std::vector<float>& getCellCounts() const { return cellCounts; }
+
+    // Centre of simulation `index`'s block in the lattice
+    glm::vec3 getSimulationOrigin(int index) const;
+    // Side length of a block: the most whole grid cells that latticeSide blocks fit in along an axis
+    float getBlockSize() const;
+
+private:
+    int simulationCount = 0;
+    int cellsPerSimulation = 0;
+    int latticeSide = 1;
+    std::vector<float> sweepValues;
+    std::vector<float> cellCounts;
+};
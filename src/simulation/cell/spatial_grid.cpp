@@ -10,36 +10,24 @@
 // Spatial partitioning
 void CellManager::initializeSpatialGrid()
 {
-    // Create double buffered grid buffers to store cell indices
-
-    glCreateBuffers(1, &gridBuffer);
-    glNamedBufferData(gridBuffer,
-        config::TOTAL_GRID_CELLS * config::MAX_CELLS_PER_GRID * sizeof(GLuint),
-        nullptr, GL_STREAM_COPY);  // Frequently updated by GPU compute shaders
-
-    // Create double buffered grid count buffers to store number of cells per grid cell
-    glCreateBuffers(1, &gridCountBuffer);
-    glNamedBufferData(gridCountBuffer,
-        config::TOTAL_GRID_CELLS * sizeof(GLuint),
-        nullptr, GL_STREAM_COPY);  // Frequently updated by GPU compute shaders
-
-    // Create double buffered grid offset buffers for prefix sum calculations
-    glCreateBuffers(1, &gridOffsetBuffer);
-    glNamedBufferData(gridOffsetBuffer,
-        config::TOTAL_GRID_CELLS * sizeof(GLuint),
-        nullptr, GL_STREAM_COPY);  // Frequently updated by GPU compute shaders
-
-    // Create hash buffer for sparse grid optimization
-    glCreateBuffers(1, &gridHashBuffer);
-    glNamedBufferData(gridHashBuffer,
-        config::TOTAL_GRID_CELLS * sizeof(GLuint),
-        nullptr, GL_STREAM_COPY);  // Frequently updated by GPU compute shaders
-
-    // Create active cells buffer for performance optimization
-    glCreateBuffers(1, &activeCellsBuffer);
-    glNamedBufferData(activeCellsBuffer,
-        config::TOTAL_GRID_CELLS * sizeof(GLuint),
-        nullptr, GL_STREAM_COPY);  // Frequently updated by GPU compute shaders
+    // The grid buffers are always used together and never resized, so they share one arena block
+    std::vector<GPUBufferRange> ranges = bufferArena.createBlock(GPUSubsystem::Grid, {
+        config::TOTAL_GRID_CELLS * config::MAX_CELLS_PER_GRID * sizeof(GLuint), // Cell indices per grid cell
+        config::TOTAL_GRID_CELLS * sizeof(GLuint), // Number of cells per grid cell
+        config::TOTAL_GRID_CELLS * sizeof(GLuint), // Grid cell starting offsets for prefix sum calculations
+        config::TOTAL_GRID_CELLS * sizeof(GLuint), // Hash buffer for sparse grid optimization
+        config::TOTAL_GRID_CELLS * sizeof(GLuint), // Active cells buffer for performance optimization
+    }, 0); // Only written by GPU compute shaders and clears
+    if (ranges.empty())
+    {
+        std::cout << "Error: failed to allocate the spatial grid\n";
+        return;
+    }
+    gridBuffer = ranges[0];
+    gridCountBuffer = ranges[1];
+    gridOffsetBuffer = ranges[2];
+    gridHashBuffer = ranges[3];
+    activeCellsBuffer = ranges[4];
 
     std::cout << "Initialized double buffered spatial grid with " << config::TOTAL_GRID_CELLS
         << " grid cells (" << config::GRID_RESOLUTION << "^3)\n";
@@ -53,6 +41,9 @@ void CellManager::updateSpatialGrid()
         return;
     TimerGPU timer("Spatial Grid Update");
 
+    // Grid settings come from the SimulationConstants block (also called from the keyframe manager)
+    bindSimulationConstants();
+
     // ============= PERFORMANCE OPTIMIZATIONS FOR 100K CELLS =============
     // 1. Increased grid resolution from 32 to 64 (262,144 grid cells)
     // 2. Reduced max cells per grid from 64 to 32 for better memory access
@@ -62,6 +53,11 @@ void CellManager::updateSpatialGrid()
     // 6. Added early termination in physics neighbor search
     // ====================================================================
 
+    // Every per-cell pass from here to the end of the step is sized from the GPU count
+    addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    flushBarriers();
+    prepareStepDispatch();
+
     // HIGHLY OPTIMIZED: Combined operations with minimal barriers
     // Step 1: Clear grid counts and assign cells in parallel
     runGridClear();
@@ -86,42 +82,15 @@ void CellManager::updateSpatialGrid()
 
 void CellManager::cleanupSpatialGrid()
 {
-    // Clean up double buffered spatial grid buffers
-
-    if (gridBuffer != 0)
-    {
-        glDeleteBuffers(1, &gridBuffer);
-        gridBuffer = 0;
-    }
-    if (gridCountBuffer != 0)
-    {
-        glDeleteBuffers(1, &gridCountBuffer);
-        gridCountBuffer = 0;
-    }
-    if (gridOffsetBuffer != 0)
-    {
-        glDeleteBuffers(1, &gridOffsetBuffer);
-        gridOffsetBuffer = 0;
-    }
-    if (gridHashBuffer != 0)
-    {
-        glDeleteBuffers(1, &gridHashBuffer);
-        gridHashBuffer = 0;
-    }
-    if (activeCellsBuffer != 0)
-    {
-        glDeleteBuffers(1, &activeCellsBuffer);
-        activeCellsBuffer = 0;
-    }
+    // Clean up the spatial grid block
+    bufferArena.destroyBlock({ &gridBuffer, &gridCountBuffer, &gridOffsetBuffer, &gridHashBuffer, &activeCellsBuffer });
 }
 
 void CellManager::runGridClear()
 {
     gridClearShader->use();
 
-    gridClearShader->setInt("u_totalGridCells", config::TOTAL_GRID_CELLS);
-
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gridCountBuffer);
+    gridCountBuffer.bindStorage(0);
 
     // OPTIMIZED: Use larger work groups for better GPU utilization
     GLuint numGroups = (config::TOTAL_GRID_CELLS + 255) / 256; // Changed from 64 to 256
@@ -134,18 +103,13 @@ void CellManager::runGridAssign()
 {
     gridAssignShader->use();
 
-    gridAssignShader->setInt("u_gridResolution", config::GRID_RESOLUTION);
-    gridAssignShader->setFloat("u_gridCellSize", config::GRID_CELL_SIZE);
-    gridAssignShader->setFloat("u_worldSize", config::WORLD_SIZE);
-
     // Use previous buffer for spatial grid to match physics compute input
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gridCountBuffer);
+    gridCountBuffer.bindStorage(1);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gpuCellCountBuffer); // Bind GPU cell count buffer
 
     // OPTIMIZED: Use larger work groups for better memory coalescing
-    GLuint numGroups = (cellCount + 255) / 256; // Changed from 64 to 256
-    gridAssignShader->dispatch(numGroups, 1, 1);
+    gridAssignShader->dispatchIndirect(stepDispatchBuffer); // Sized from the GPU count (see prepareStepDispatch)
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
@@ -154,10 +118,8 @@ void CellManager::runGridPrefixSum()
 {
     gridPrefixSumShader->use();
 
-    gridPrefixSumShader->setInt("u_totalGridCells", config::TOTAL_GRID_CELLS);
-
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gridCountBuffer);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gridOffsetBuffer);
+    gridCountBuffer.bindStorage(0);
+    gridOffsetBuffer.bindStorage(1);
 
     // OPTIMIZED: Use 256-sized work groups to match shader implementation
     GLuint numGroups = (config::TOTAL_GRID_CELLS + 255) / 256; // Changed from 64 to 256
@@ -168,19 +130,17 @@ void CellManager::runGridPrefixSum()
 
 void CellManager::runGridInsert()
 {
-    gridInsertShader->use();    gridInsertShader->setInt("u_gridResolution", config::GRID_RESOLUTION);
-    gridInsertShader->setFloat("u_gridCellSize", config::GRID_CELL_SIZE);
-    gridInsertShader->setFloat("u_worldSize", config::WORLD_SIZE);
-    gridInsertShader->setInt("u_maxCellsPerGrid", config::MAX_CELLS_PER_GRID); // Use previous buffer for spatial grid to match physics compute input
+    gridInsertShader->use();
+
+    // Use previous buffer for spatial grid to match physics compute input
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getCellReadBuffer());
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gridBuffer);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, gridOffsetBuffer);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, gridCountBuffer);
+    gridBuffer.bindStorage(1);
+    gridOffsetBuffer.bindStorage(2);
+    gridCountBuffer.bindStorage(3);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, gpuCellCountBuffer); // Bind GPU cell count buffer
 
     // OPTIMIZED: Use larger work groups for better memory coalescing
-    GLuint numGroups = (cellCount + 255) / 256; // Changed from 64 to 256
-    gridInsertShader->dispatch(numGroups, 1, 1);
+    gridInsertShader->dispatchIndirect(stepDispatchBuffer); // Sized from the GPU count (see prepareStepDispatch)
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
\ No newline at end of file
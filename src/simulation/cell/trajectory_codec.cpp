@@ -0,0 +1,238 @@
+#include "trajectory_codec.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+
+    // Which field a column belongs to (columns of unrecorded fields are skipped entirely)
+    uint32_t columnField(int column)
+    {
+        if (column < 4) return TRAJECTORY_FIELD_POSITION;
+        if (column < 8) return TRAJECTORY_FIELD_ORIENTATION;
+        if (column == 8) return TRAJECTORY_FIELD_MODE;
+        return TRAJECTORY_FIELD_AGE;
+    }
+
+    // Quantisation step of a column, 0 for the exact integer mode column
+    float columnStep(const TrajectoryFileHeader& header, int column)
+    {
+        if (column < 4) return header.positionStep;
+        if (column < 8) return header.orientationStep;
+        if (column == 8) return 0.0f;
+        return header.ageStep;
+    }
+
+    int32_t quantise(float value, float step)
+    {
+        if (!std::isfinite(value)) return 0;
+        double steps = std::round(static_cast<double>(value) / step);
+        return static_cast<int32_t>(std::clamp(steps, -2147483647.0, 2147483647.0));
+    }
+
+    int32_t columnValue(const TrajectoryFrameView& frame, int column, int index, float step)
+    {
+        if (column < 4) return quantise(frame.positionAndMass[index][column], step);
+        if (column < 8) return quantise(frame.orientation[index][column - 4], step);
+        if (column == 8) return frame.modeIndex[index];
+        return quantise(frame.age[index], step);
+    }
+
+    float dequantise(int32_t value, float step)
+    {
+        return static_cast<float>(static_cast<double>(value) * step);
+    }
+
+    // Residual writer with zero-run coding
+    struct ResidualWriter
+    {
+        std::vector<uint8_t>& out;
+        uint64_t zeroRun = 0;
+
+        void write(int64_t residual)
+        {
+            if (residual == 0)
+            {
+                zeroRun++;
+                return;
+            }
+            flush();
+            writeVarint(out, zigzag(residual) << 1);
+        }
+
+        void flush()
+        {
+            if (zeroRun > 0)
+            {
+                writeVarint(out, (zeroRun << 1) | 1);
+                zeroRun = 0;
+            }
+        }
+    };
+
+    // Residual reader for the same coding; bounds checked because playback reads files that may be truncated
+    struct ResidualReader
+    {
+        const uint8_t* in;
+        const uint8_t* end;
+        uint64_t zeroRun = 0;
+        bool ok = true;
+
+        int64_t read()
+        {
+            if (zeroRun > 0)
+            {
+                zeroRun--;
+                return 0;
+            }
+
+            uint64_t token = 0;
+            int shift = 0;
+            while (true)
+            {
+                if (in == end || shift > 63) { ok = false; return 0; }
+                uint8_t byte = *in++;
+                token |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) break;
+            }
+
+            if (token & 1)
+            {
+                if ((token >> 1) == 0) { ok = false; return 0; }
+                zeroRun = (token >> 1) - 1; // This call returns the first zero of the run
+                return 0;
+            }
+            uint64_t value = token >> 1;
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+    };
+}
+
+void TrajectoryEncoder::reset(const TrajectoryFileHeader& header)
+{
+    fileHeader = header;
+    for (std::vector<int32_t>& column : previous)
+    {
+        column.clear();
+    }
+    previousCellCount = 0;
+    previousTime = 0.0;
+    framesSinceKey = 0;
+    hasPrevious = false;
+}
+
+void TrajectoryEncoder::encode(const TrajectoryFrameView& frame, uint64_t tick, double time, TrajectoryFrameHeader& frameHeader, std::vector<uint8_t>& payload)
+{
+    bool isKey = !hasPrevious || framesSinceKey >= fileHeader.keyframeInterval;
+    framesSinceKey = isKey ? 1 : framesSinceKey + 1;
+
+    // Ages grow with simulation time, so predicting that growth leaves a zero residual for most cells
+    int64_t agePrediction = isKey ? 0 : static_cast<int64_t>(std::llround((time - previousTime) / fileHeader.ageStep));
+    int carriedCells = isKey ? 0 : std::min(frame.cellCount, previousCellCount);
+
+    payload.clear();
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        if ((fileHeader.fieldMask & columnField(column)) == 0)
+            continue;
+
+        float step = columnStep(fileHeader, column);
+        int64_t prediction = column == 9 ? agePrediction : 0;
+        std::vector<int32_t>& last = previous[column];
+        last.resize(frame.cellCount, 0);
+
+        ResidualWriter writer{ payload };
+        for (int i = 0; i < frame.cellCount; i++)
+        {
+            int32_t value = columnValue(frame, column, i, step);
+            int64_t base = i < carriedCells ? static_cast<int64_t>(last[i]) + prediction : 0;
+            writer.write(static_cast<int64_t>(value) - base);
+            last[i] = value;
+        }
+        writer.flush();
+    }
+
+    previousCellCount = frame.cellCount;
+    previousTime = time;
+    hasPrevious = true;
+
+    frameHeader = TrajectoryFrameHeader{};
+    frameHeader.flags = isKey ? TRAJECTORY_FRAME_KEY : 0;
+    frameHeader.tick = tick;
+    frameHeader.time = time;
+    frameHeader.cellCount = frame.cellCount;
+    frameHeader.payloadBytes = static_cast<uint32_t>(payload.size());
+}
+
+void TrajectoryDecoder::reset(const TrajectoryFileHeader& header)
+{
+    fileHeader = header;
+    for (std::vector<int32_t>& column : previous)
+    {
+        column.clear();
+    }
+    previousCellCount = 0;
+    previousTime = 0.0;
+    hasPrevious = false;
+}
+
+bool TrajectoryDecoder::decode(const TrajectoryFrameHeader& frameHeader, const uint8_t* payload, std::vector<ComputeCell>& cells)
+{
+    bool isKey = (frameHeader.flags & TRAJECTORY_FRAME_KEY) != 0;
+    if ((!isKey && !hasPrevious) || frameHeader.cellCount < 0)
+        return false;
+
+    // Same predictions as the encoder
+    int64_t agePrediction = isKey ? 0 : static_cast<int64_t>(std::llround((frameHeader.time - previousTime) / fileHeader.ageStep));
+    int carriedCells = isKey ? 0 : std::min(frameHeader.cellCount, previousCellCount);
+
+    cells.resize(frameHeader.cellCount);
+    ResidualReader reader{ payload, payload + frameHeader.payloadBytes };
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        if ((fileHeader.fieldMask & columnField(column)) == 0)
+            continue;
+
+        float step = columnStep(fileHeader, column);
+        int64_t prediction = column == 9 ? agePrediction : 0;
+        std::vector<int32_t>& last = previous[column];
+        last.resize(frameHeader.cellCount, 0);
+
+        for (int i = 0; i < frameHeader.cellCount; i++)
+        {
+            int64_t base = i < carriedCells ? static_cast<int64_t>(last[i]) + prediction : 0;
+            int32_t value = static_cast<int32_t>(base + reader.read());
+            last[i] = value;
+
+            ComputeCell& cell = cells[i];
+            if (column < 4) cell.positionAndMass[column] = dequantise(value, step);
+            else if (column < 8) cell.orientation[column - 4] = dequantise(value, step);
+            else if (column == 8) cell.modeIndex = value;
+            else cell.age = dequantise(value, step);
+        }
+        if (reader.zeroRun != 0)
+            reader.ok = false; // A run never crosses a column boundary
+    }
+    if (!reader.ok || reader.in != reader.end)
+    {
+        hasPrevious = false;
+        return false;
+    }
+
+    previousCellCount = frameHeader.cellCount;
+    previousTime = frameHeader.time;
+    hasPrevious = true;
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "common_structs.h"
+
+// Recorded trajectory file format (little endian, append-only):
+//   TrajectoryFileHeader
+//   repeated: TrajectoryFrameHeader + payloadBytes of encoded columns
+//
+// A frame holds the selected fields of every cell as planar columns (x, y, z, mass, orientation xyzw,
+// mode, age). Float columns are quantised with the steps in the file header and stored as residuals
+// against the previous frame's decoded value of the same cell index (age is predicted to have grown by
+// the elapsed time). Every keyframeInterval-th frame is a key frame whose residuals are taken against
+// zero, so playback can seek to it without decoding anything earlier.
+//
+// Residual streams are run-length coded: a varint token with the low bit set is a run of (token >> 1)
+// zero residuals, otherwise it is zigzag(residual) << 1. Cells that didn't move cost a fraction of a byte.
+constexpr uint32_t TRAJECTORY_MAGIC = 0x52545342;       // "BSTR"
+constexpr uint32_t TRAJECTORY_FRAME_MAGIC = 0x4D415246; // "FRAM"
+constexpr uint32_t TRAJECTORY_VERSION = 1;
+
+enum TrajectoryField : uint32_t
+{
+    TRAJECTORY_FIELD_POSITION = 1 << 0,    // positionAndMass (mass is needed for the rendered radius)
+    TRAJECTORY_FIELD_ORIENTATION = 1 << 1,
+    TRAJECTORY_FIELD_MODE = 1 << 2,
+    TRAJECTORY_FIELD_AGE = 1 << 3,
+    TRAJECTORY_FIELD_ALL = 0xF
+};
+
+constexpr uint32_t TRAJECTORY_FRAME_KEY = 1 << 0;
+
+struct TrajectoryFileHeader
+{
+    uint32_t magic = TRAJECTORY_MAGIC;
+    uint32_t version = TRAJECTORY_VERSION;
+    uint32_t headerSize = sizeof(TrajectoryFileHeader);
+    uint32_t fieldMask = TRAJECTORY_FIELD_ALL;
+    int32_t recordInterval = 1;     // Simulation ticks between recorded frames
+    int32_t keyframeInterval = 1;   // Recorded frames between key frames
+    float physicsTimeStep = 0.0f;
+    float positionStep = 0.0f;      // Quantisation steps (restored values are within half a step)
+    float orientationStep = 0.0f;
+    float ageStep = 0.0f;
+};
+
+struct TrajectoryFrameHeader
+{
+    uint32_t magic = TRAJECTORY_FRAME_MAGIC;
+    uint32_t flags = 0;             // TRAJECTORY_FRAME_KEY
+    uint64_t tick = 0;
+    double time = 0.0;
+    int32_t cellCount = 0;
+    uint32_t payloadBytes = 0;
+};
+
+static_assert(sizeof(TrajectoryFileHeader) == 40, "TrajectoryFileHeader layout is part of the file format");
+static_assert(sizeof(TrajectoryFrameHeader) == 32, "TrajectoryFrameHeader layout is part of the file format");
+
+// Planar view of one captured frame (pointers may be null for fields that aren't recorded)
+struct TrajectoryFrameView
+{
+    int cellCount = 0;
+    const glm::vec4* positionAndMass = nullptr;
+    const glm::vec4* orientation = nullptr;
+    const int32_t* modeIndex = nullptr;
+    const float* age = nullptr;
+};
+
+class TrajectoryEncoder
+{
+public:
+    // Starts a new stream; the next frame is a key frame
+    void reset(const TrajectoryFileHeader& header);
+
+    // Encodes a frame into payload (replacing its contents) and fills in the frame header
+    void encode(const TrajectoryFrameView& frame, uint64_t tick, double time, TrajectoryFrameHeader& frameHeader, std::vector<uint8_t>& payload);
+
+private:
+    static constexpr int COLUMN_COUNT = 10; // x, y, z, mass, orientation xyzw, mode, age
+
+    TrajectoryFileHeader fileHeader;
+    std::vector<int32_t> previous[COLUMN_COUNT]; // Quantised value per column and cell index in the last frame
+    int previousCellCount = 0;
+    double previousTime = 0.0;
+    int framesSinceKey = 0;
+    bool hasPrevious = false;
+};
+
+class TrajectoryDecoder
+{
+public:
+    // Starts a new stream; the next frame decoded must be a key frame
+    void reset(const TrajectoryFileHeader& header);
+
+    // Decodes a frame on top of the previously decoded one and writes the recorded fields into cells
+    // (resized to the frame's cell count, fields that aren't recorded keep their previous/default values).
+    // Returns false for corrupt payloads or a delta frame without a preceding frame.
+    bool decode(const TrajectoryFrameHeader& frameHeader, const uint8_t* payload, std::vector<ComputeCell>& cells);
+
+private:
+    static constexpr int COLUMN_COUNT = 10;
+
+    TrajectoryFileHeader fileHeader;
+    std::vector<int32_t> previous[COLUMN_COUNT];
+    int previousCellCount = 0;
+    double previousTime = 0.0;
+    bool hasPrevious = false;
+};
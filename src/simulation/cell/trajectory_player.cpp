@@ -0,0 +1,151 @@
+#include "trajectory_player.h"
+#include "cell_manager.h"
+#include "../../utils/timer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+bool TrajectoryPlayer::open(const std::string& newPath)
+{
+    close();
+    if (!file.open(newPath))
+    {
+        std::cout << "Error: could not open trajectory " << newPath << "\n";
+        return false;
+    }
+
+    if (file.size() < sizeof(TrajectoryFileHeader))
+    {
+        std::cout << "Error: " << newPath << " is not a trajectory (file too small)\n";
+        file.close();
+        return false;
+    }
+    std::memcpy(&fileHeader, file.data(), sizeof(TrajectoryFileHeader));
+    if (fileHeader.magic != TRAJECTORY_MAGIC || fileHeader.version != TRAJECTORY_VERSION ||
+        fileHeader.headerSize < sizeof(TrajectoryFileHeader))
+    {
+        std::cout << "Error: " << newPath << " is not a supported trajectory file\n";
+        file.close();
+        return false;
+    }
+    if ((fileHeader.fieldMask & TRAJECTORY_FIELD_POSITION) == 0)
+    {
+        std::cout << "Error: " << newPath << " has no positions recorded, nothing to play back\n";
+        file.close();
+        return false;
+    }
+
+    // Index the frames; a recording that is still running (or was cut off) simply ends at its last complete frame
+    size_t offset = fileHeader.headerSize;
+    int lastKey = -1;
+    while (file.size() - offset >= sizeof(TrajectoryFrameHeader))
+    {
+        TrajectoryFrameHeader frameHeader;
+        std::memcpy(&frameHeader, file.data() + offset, sizeof(frameHeader));
+        if (frameHeader.magic != TRAJECTORY_FRAME_MAGIC ||
+            frameHeader.payloadBytes > file.size() - offset - sizeof(frameHeader))
+            break;
+
+        if (frameHeader.flags & TRAJECTORY_FRAME_KEY)
+            lastKey = static_cast<int>(frames.size());
+        if (lastKey >= 0) // Frames before the first key frame can't be decoded
+        {
+            FrameEntry entry;
+            entry.offset = offset;
+            entry.time = frameHeader.time;
+            entry.keyFrame = lastKey;
+            frames.push_back(entry);
+        }
+        offset += sizeof(frameHeader) + frameHeader.payloadBytes;
+    }
+
+    if (frames.empty())
+    {
+        std::cout << "Error: trajectory " << newPath << " contains no frames\n";
+        file.close();
+        return false;
+    }
+
+    path = newPath;
+    decoder.reset(fileHeader);
+    currentFrame = -1;
+    uploadedFrame = -1;
+    playbackTime = getStartTime();
+    std::cout << "Opened trajectory " << path << ": " << frames.size() << " frames, "
+        << getStartTime() << "s to " << getEndTime() << "s\n";
+    return true;
+}
+
+void TrajectoryPlayer::close()
+{
+    file.close();
+    frames.clear();
+    cells.clear();
+    path.clear();
+    currentFrame = -1;
+    uploadedFrame = -1;
+}
+
+bool TrajectoryPlayer::decodeFrame(int index)
+{
+    const FrameEntry& entry = frames[index];
+    TrajectoryFrameHeader frameHeader;
+    std::memcpy(&frameHeader, file.data() + entry.offset, sizeof(frameHeader));
+    if (!decoder.decode(frameHeader, file.data() + entry.offset + sizeof(frameHeader), cells))
+    {
+        std::cout << "Warning: trajectory frame " << index << " is corrupt\n";
+        currentFrame = -1;
+        return false;
+    }
+    currentFrame = index;
+    return true;
+}
+
+bool TrajectoryPlayer::showFrameAt(double time, CellManager& cellManager)
+{
+    if (frames.empty())
+        return false;
+
+    // Last frame at or before `time`
+    auto it = std::upper_bound(frames.begin(), frames.end(), time,
+        [](double t, const FrameEntry& entry) { return t < entry.time; });
+    int target = std::max(0, static_cast<int>(it - frames.begin()) - 1);
+
+    if (target != currentFrame)
+    {
+        TimerCPU cpuTimer("Trajectory Decode");
+
+        // Decode forward from the current frame if that is at least as close as the key frame
+        int first = frames[target].keyFrame;
+        if (currentFrame >= first && currentFrame < target)
+            first = currentFrame + 1;
+        for (int i = first; i <= target; i++)
+        {
+            if (!decodeFrame(i))
+                return false;
+        }
+    }
+
+    if (uploadedFrame != currentFrame)
+    {
+        cellManager.uploadPlaybackCells(cells);
+        uploadedFrame = currentFrame;
+    }
+    return true;
+}
+
+void TrajectoryPlayer::update(CellManager& cellManager, double deltaTime)
+{
+    if (frames.empty())
+        return;
+
+    if (playing)
+    {
+        playbackTime += deltaTime;
+        if (playbackTime > getEndTime())
+            playbackTime = loop ? getStartTime() : getEndTime();
+    }
+    playbackTime = std::clamp(playbackTime, getStartTime(), getEndTime());
+    showFrameAt(playbackTime, cellManager);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trajectory_codec.h"
+#include "../../utils/mapped_file.h"
+
+struct CellManager;
+
+// Plays a recorded trajectory file back through the normal cell rendering path instead of simulating.
+// The file is memory-mapped and indexed once on open (frame headers only); showing a time decodes forward
+// from the nearest key frame (or from the current frame when that is closer) and uploads the result into
+// the CellManager's read buffer, where renderCellsUnified picks it up like any simulated state.
+class TrajectoryPlayer
+{
+public:
+    // Maps and indexes the file; returns false if it isn't a readable trajectory with position data
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return !frames.empty(); }
+
+    // Advances playback by deltaTime (simulation seconds) when playing and shows the frame for the new time
+    void update(CellManager& cellManager, double deltaTime);
+    // Shows the last frame at or before `time` (scrubbing seeks in the file, nothing is simulated)
+    bool showFrameAt(double time, CellManager& cellManager);
+
+    bool playing = true;
+    bool loop = true;
+    double getPlaybackTime() const { return playbackTime; }
+    void setPlaybackTime(double time) { playbackTime = time; }
+    double getStartTime() const { return frames.empty() ? 0.0 : frames.front().time; }
+    double getEndTime() const { return frames.empty() ? 0.0 : frames.back().time; }
+    size_t getFrameCount() const { return frames.size(); }
+    int getCurrentFrame() const { return currentFrame; }
+    const std::string& getPath() const { return path; }
+
+private:
+    struct FrameEntry
+    {
+        size_t offset = 0;  // Of the TrajectoryFrameHeader in the file
+        double time = 0.0;
+        int keyFrame = 0;   // Index of the key frame this frame decodes from
+    };
+
+    bool decodeFrame(int index);
+
+    MappedFile file;
+    std::string path;
+    TrajectoryFileHeader fileHeader;
+    std::vector<FrameEntry> frames;
+    TrajectoryDecoder decoder;
+    std::vector<ComputeCell> cells; // Last decoded frame
+    int currentFrame = -1;          // Frame held in `cells`
+    int uploadedFrame = -1;         // Frame last uploaded to the GPU
+    double playbackTime = 0.0;
+};
@@ -0,0 +1,310 @@
+#include "trajectory_recorder.h"
+#include "cell_manager.h"
+#include "../../rendering/core/shader_class.h"
+#include "../../utils/timer.h"
+
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    GLintptr alignOffset(GLintptr offset)
+    {
+        constexpr GLintptr alignment = 256; // Covers GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT on all desktop GPUs
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    stop();
+}
+
+bool TrajectoryRecorder::start(const std::string& newPath, CellManager& cellManager, uint32_t fieldMask, int recordInterval)
+{
+    stop();
+
+    std::filesystem::path filePath(newPath);
+    if (filePath.has_parent_path())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(filePath.parent_path(), error);
+    }
+    file.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: could not create trajectory file " << newPath << "\n";
+        return false;
+    }
+
+    path = newPath;
+    fileHeader = TrajectoryFileHeader{};
+    fileHeader.fieldMask = fieldMask & TRAJECTORY_FIELD_ALL;
+    fileHeader.recordInterval = recordInterval > 0 ? recordInterval : 1;
+    fileHeader.keyframeInterval = config::TRAJECTORY_KEYFRAME_INTERVAL;
+    fileHeader.physicsTimeStep = config::physicsTimeStep;
+    fileHeader.positionStep = config::TRAJECTORY_POSITION_STEP;
+    fileHeader.orientationStep = config::TRAJECTORY_ORIENTATION_STEP;
+    fileHeader.ageStep = config::TRAJECTORY_AGE_STEP;
+    file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    encoder.reset(fileHeader);
+
+    if (!allocateRing(cellManager.bufferArena, cellManager.getCellLimit()))
+    {
+        file.close();
+        return false;
+    }
+
+    packShader = new Shader("shaders/cell/management/trajectory_pack.comp");
+
+    for (Slot& slot : slots)
+    {
+        slot.state = SLOT_FREE;
+        slot.fence = nullptr;
+    }
+    nextSlot = 0;
+    tick = 0;
+    framesWritten = 0;
+    framesDropped = 0;
+    rawBytes = 0;
+    encodedBytes = sizeof(fileHeader);
+
+    writing = false;
+    stopWriter = false;
+    writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+    recording = true;
+
+    std::cout << "Recording trajectory to " << path << " every " << fileHeader.recordInterval << " ticks\n";
+    return true;
+}
+
+void TrajectoryRecorder::stop()
+{
+    if (!recording)
+        return;
+    recording = false;
+
+    // Hand over everything the GPU still owes us, then let the writer drain its queue
+    pollFences(true);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWriter = true;
+    }
+    queueCondition.notify_one();
+    writer.join();
+    file.close();
+
+    releaseRing();
+    if (packShader)
+    {
+        packShader->destroy();
+        delete packShader;
+        packShader = nullptr;
+    }
+
+    Stats stats = getStats();
+    std::cout << "Stopped trajectory recording: " << stats.framesWritten << " frames written, "
+        << stats.framesDropped << " dropped, " << stats.encodedBytes / 1024 << " KB\n";
+}
+
+bool TrajectoryRecorder::allocateRing(GPUBufferArena& arena, int capacity)
+{
+    // Planar slot layout, every array aligned so it can be bound with glBindBufferRange
+    slotCapacity = capacity;
+    orientationOffset = alignOffset(static_cast<GLintptr>(slotCapacity) * sizeof(glm::vec4));
+    modeOffset = alignOffset(orientationOffset + static_cast<GLintptr>(slotCapacity) * sizeof(glm::vec4));
+    ageOffset = alignOffset(modeOffset + static_cast<GLintptr>(slotCapacity) * sizeof(int32_t));
+    countOffset = alignOffset(ageOffset + static_cast<GLintptr>(slotCapacity) * sizeof(float));
+    slotBytes = alignOffset(countOffset + sizeof(uint32_t));
+
+    // Host-visible ring the pack shader writes into directly; the writer thread reads it in place
+    GLbitfield mapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    ringArena = &arena;
+    ringBuffer = ringArena->createBuffer(GPUSubsystem::Trajectory, slotBytes * config::TRAJECTORY_RING_SLOTS, mapFlags | GL_CLIENT_STORAGE_BIT);
+    if (ringBuffer != 0)
+    {
+        ringPtr = static_cast<uint8_t*>(glMapNamedBufferRange(ringBuffer, 0, slotBytes * config::TRAJECTORY_RING_SLOTS, mapFlags));
+    }
+    if (!ringPtr)
+    {
+        std::cout << "Error: could not allocate the trajectory ring buffer for " << capacity << " cells\n";
+        ringArena->destroyBuffer(ringBuffer);
+        ringArena = nullptr;
+        slotCapacity = 0;
+        return false;
+    }
+    return true;
+}
+
+void TrajectoryRecorder::releaseRing()
+{
+    if (ringBuffer != 0)
+    {
+        glUnmapNamedBuffer(ringBuffer);
+        ringArena->destroyBuffer(ringBuffer);
+    }
+    ringArena = nullptr;
+    ringPtr = nullptr;
+    slotCapacity = 0;
+}
+
+void TrajectoryRecorder::drainRing()
+{
+    pollFences(true);
+    std::unique_lock<std::mutex> lock(queueMutex);
+    drainCondition.wait(lock, [this] { return writeQueue.empty() && !writing; });
+}
+
+void TrajectoryRecorder::onTick(CellManager& cellManager, double simulationTime)
+{
+    if (!recording)
+        return;
+
+    // The cell limit was raised: frames must not be cut at the old limit, so move to a ring that fits the new one
+    if (cellManager.getCellLimit() > slotCapacity)
+    {
+        drainRing();
+        releaseRing();
+        if (!allocateRing(cellManager.bufferArena, cellManager.getCellLimit()))
+        {
+            std::cout << "Error: trajectory recording stopped, the cell limit outgrew the ring buffer\n";
+            stop();
+            return;
+        }
+        nextSlot = 0;
+    }
+
+    pollFences(false);
+
+    if (tick++ % fileHeader.recordInterval != 0)
+        return;
+
+    Slot& slot = slots[nextSlot];
+    if (slot.state.load() != SLOT_FREE)
+    {
+        framesDropped++; // The writer is behind; never stall the simulation for it
+        return;
+    }
+
+    TimerGPU gpuTimer("Trajectory Capture");
+
+    // The step's cell and counter writes have to land before the pack shader reads them
+    cellManager.addBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    cellManager.flushBarriers();
+
+    // Recorded frames hold every cell: the shader takes the count from the GPU counters (clamped to the slot)
+    // instead of the CPU's snapshot, which can be a few ticks old, so the dispatch covers the whole slot
+    GLintptr base = slotBytes * nextSlot;
+    packShader->use();
+    packShader->setInt("u_slotCapacity", slotCapacity);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellManager.getCellReadBuffer());
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, ringBuffer, base, orientationOffset);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, ringBuffer, base + orientationOffset, modeOffset - orientationOffset);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 3, ringBuffer, base + modeOffset, ageOffset - modeOffset);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 4, ringBuffer, base + ageOffset, countOffset - ageOffset);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 5, ringBuffer, base + countOffset, slotBytes - countOffset);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, cellManager.gpuCellCountBuffer);
+    packShader->dispatch((slotCapacity + 255) / 256, 1, 1);
+
+    // Shader writes to a persistently mapped buffer need this barrier before the fence makes them visible
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.tick = tick - 1;
+    slot.time = simulationTime;
+    slot.state = SLOT_GPU_PENDING;
+    gpuPending.push_back(nextSlot);
+
+    nextSlot = (nextSlot + 1) % config::TRAJECTORY_RING_SLOTS;
+}
+
+void TrajectoryRecorder::pollFences(bool wait)
+{
+    // Slots are captured in order, so only the oldest pending fence needs checking
+    while (!gpuPending.empty())
+    {
+        Slot& slot = slots[gpuPending.front()];
+        GLenum result = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return;
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        slot.state = SLOT_QUEUED;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            writeQueue.push_back(gpuPending.front());
+        }
+        queueCondition.notify_one();
+        gpuPending.pop_front();
+    }
+}
+
+TrajectoryFrameView TrajectoryRecorder::slotView(int slot) const
+{
+    const uint8_t* base = ringPtr + slotBytes * slot;
+    TrajectoryFrameView view;
+    view.cellCount = static_cast<int>(*reinterpret_cast<const uint32_t*>(base + countOffset)); // Written by the pack shader
+    view.positionAndMass = reinterpret_cast<const glm::vec4*>(base);
+    view.orientation = reinterpret_cast<const glm::vec4*>(base + orientationOffset);
+    view.modeIndex = reinterpret_cast<const int32_t*>(base + modeOffset);
+    view.age = reinterpret_cast<const float*>(base + ageOffset);
+    return view;
+}
+
+void TrajectoryRecorder::writerLoop()
+{
+    std::vector<uint8_t> payload;
+    TrajectoryFrameHeader frameHeader;
+
+    // Bytes a frame occupies in the ring, counting only the recorded fields
+    uint64_t bytesPerCell = 0;
+    if (fileHeader.fieldMask & TRAJECTORY_FIELD_POSITION) bytesPerCell += sizeof(glm::vec4);
+    if (fileHeader.fieldMask & TRAJECTORY_FIELD_ORIENTATION) bytesPerCell += sizeof(glm::vec4);
+    if (fileHeader.fieldMask & TRAJECTORY_FIELD_MODE) bytesPerCell += sizeof(int32_t);
+    if (fileHeader.fieldMask & TRAJECTORY_FIELD_AGE) bytesPerCell += sizeof(float);
+
+    while (true)
+    {
+        int slotIndex;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return !writeQueue.empty() || stopWriter; });
+            if (writeQueue.empty())
+                break; // Stopped and drained
+            slotIndex = writeQueue.front();
+            writeQueue.pop_front();
+            writing = true;
+        }
+
+        // Read before the slot is freed, the render thread may refill it right after
+        Slot& slot = slots[slotIndex];
+        TrajectoryFrameView view = slotView(slotIndex);
+        int cellCount = view.cellCount;
+        encoder.encode(view, slot.tick, slot.time, frameHeader, payload);
+        slot.state = SLOT_FREE; // Encoded, the ring slot can be reused
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            writing = false;
+        }
+        drainCondition.notify_all();
+
+        file.write(reinterpret_cast<const char*>(&frameHeader), sizeof(frameHeader));
+        file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+        framesWritten++;
+        rawBytes += bytesPerCell * cellCount;
+        encodedBytes += sizeof(frameHeader) + payload.size();
+    }
+    file.flush();
+}
+
+TrajectoryRecorder::Stats TrajectoryRecorder::getStats() const
+{
+    Stats stats;
+    stats.framesWritten = framesWritten.load();
+    stats.framesDropped = framesDropped.load();
+    stats.rawBytes = rawBytes.load();
+    stats.encodedBytes = encodedBytes.load();
+    return stats;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "trajectory_codec.h"
+#include "../../core/config.h"
+
+struct CellManager;
+class GPUBufferArena;
+class Shader;
+
+// Records per-tick histories of selected cell fields to an append-only trajectory file (see trajectory_codec.h).
+//
+// Every recordInterval ticks a compute pass packs the selected fields into the next slot of a persistently
+// mapped ring buffer and drops a fence behind it. Later ticks poll the fence without waiting; once the GPU is
+// done the slot is handed to a writer thread, which encodes it straight out of the mapping and appends it
+// to the file. The render thread never blocks on the GPU or on disk: if every slot is still busy,
+// the frame is dropped and counted instead. Raising the cell limit while recording is the one exception:
+// the ring is drained and reallocated for the new limit so no frame gets truncated.
+class TrajectoryRecorder
+{
+public:
+    struct Stats
+    {
+        uint64_t framesWritten = 0;
+        uint64_t framesDropped = 0;
+        uint64_t rawBytes = 0;     // Size of the captured columns
+        uint64_t encodedBytes = 0; // Bytes appended to the file, headers included
+    };
+
+    ~TrajectoryRecorder();
+
+    // Opens the file and allocates the ring for cellManager's cell limit from its buffer arena (Trajectory subsystem);
+    // returns false if the file can't be created or the ring can't be allocated. Stop before cellManager is destroyed.
+    bool start(const std::string& path, CellManager& cellManager, uint32_t fieldMask = TRAJECTORY_FIELD_ALL,
+               int recordInterval = config::TRAJECTORY_RECORD_INTERVAL);
+    // Writes out every frame still in flight and closes the file
+    void stop();
+    bool isRecording() const { return recording; }
+
+    // Call after each simulation tick of the recorded simulation
+    void onTick(CellManager& cellManager, double simulationTime);
+
+    Stats getStats() const;
+    const std::string& getPath() const { return path; }
+
+private:
+    enum SlotState : int { SLOT_FREE, SLOT_GPU_PENDING, SLOT_QUEUED };
+
+    struct Slot
+    {
+        std::atomic<int> state{ SLOT_FREE };
+        GLsync fence = nullptr;
+        uint64_t tick = 0;
+        double time = 0.0;
+    };
+
+    // Lays out and allocates the ring for `capacity` cells per slot
+    bool allocateRing(GPUBufferArena& arena, int capacity);
+    void releaseRing();
+    // Waits until the GPU and the writer are done with every slot
+    void drainRing();
+    void pollFences(bool wait);
+    void writerLoop();
+    TrajectoryFrameView slotView(int slot) const;
+
+    bool recording = false;
+    std::string path;
+    TrajectoryFileHeader fileHeader;
+    uint64_t tick = 0;
+
+    // Ring buffer: each slot holds planar positionAndMass, orientation, mode and age arrays
+    Shader* packShader = nullptr;
+    GPUBufferArena* ringArena = nullptr; // Arena of the recorded CellManager, which owns ringBuffer
+    GLuint ringBuffer{};
+    uint8_t* ringPtr = nullptr;
+    int slotCapacity = 0;          // Cells per slot
+    GLintptr slotBytes = 0;
+    GLintptr orientationOffset = 0, modeOffset = 0, ageOffset = 0, countOffset = 0; // Within a slot; the cell count is written by the GPU
+    std::array<Slot, config::TRAJECTORY_RING_SLOTS> slots;
+    int nextSlot = 0;
+    std::deque<int> gpuPending;    // Slots waiting for their fence, oldest first (render thread only)
+
+    // Writer thread
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<int> writeQueue;
+    bool writing = false;          // The writer is encoding a slot it already took off the queue
+    std::condition_variable drainCondition;
+    bool stopWriter = false;
+    std::ofstream file;
+    TrajectoryEncoder encoder;
+
+    std::atomic<uint64_t> framesWritten{ 0 };
+    std::atomic<uint64_t> framesDropped{ 0 };
+    std::atomic<uint64_t> rawBytes{ 0 };
+    std::atomic<uint64_t> encodedBytes{ 0 };
+};
@@ -8,76 +8,261 @@
 #include <cstdlib>
 #include <cstdio>
 #include <iostream>
+#include <chrono>
+#include <memory>
+
+#include "../scene/scene_manager.h"
+
+UIManager::~UIManager() = default; // Here so unique_ptr<CellManager> sees the complete type
 
 void UIManager::initializeKeyframes(CellManager& cellManager)
 {
-    // Save current time slider position
-    float savedCurrentTime = currentTime;
-    float savedTargetTime = targetTime;
+    // The build runs on its own simulation so the preview the user is looking at is left alone
+    if (!keyframeCellManager)
+    {
+        keyframeCellManager = std::make_unique<CellManager>();
+    }
+    CellManager& builder = *keyframeCellManager;
+    builder.setCellLimit(cellManager.getCellLimit());
     
-    // Clear existing keyframes
-    keyframes.clear();
-    keyframes.resize(MAX_KEYFRAMES);
+    // Clear existing keyframes (the genome is stored once for the whole timeline)
+    keyframes.reset(currentGenome);
+    keyframeArena.reset();
     
-    // Reset simulation to initial state
-    cellManager.resetSimulation();
-    cellManager.addGenomeToBuffer(currentGenome);
+    // Reset the build simulation to the initial state
+    builder.resetSimulation();
+    builder.addGenomeToBuffer(currentGenome);
     ComputeCell newCell{};
     newCell.modeIndex = currentGenome.initialMode;
-    cellManager.addCellToStagingBuffer(newCell);
-    cellManager.addStagedCellsToQueueBuffer();
+    newCell.orientation = currentGenome.initialOrientation;
+    builder.addCellToStagingBuffer(newCell);
+    builder.addStagedCellsToQueueBuffer();
+    
+    // Capture initial keyframe at time 0; the rest follow in updateKeyframeBuild
+    captureKeyframe(builder, 0.0f, 0);
     
-    // Capture initial keyframe at time 0
-    captureKeyframe(cellManager, 0.0f, 0);
+    keyframeBuild.active = true;
+    keyframeBuild.simulatedTime = 0.0f;
+    keyframeBuild.replayCellSteps = 0.0;
+    keyframeBuild.cellStepBudget = static_cast<double>(config::KEYFRAME_REPLAY_STEPS) * std::max(1, builder.getCellLimit());
     
-    // Calculate time interval between keyframes
-    float timeInterval = maxTime / (MAX_KEYFRAMES - 1);
+    // Scrubbing works as soon as the first keyframe exists, later ones are used as they arrive
+    keyframesInitialized = true;
     
-    // Simulate and capture keyframes (keeping your original time step logic)
-    for (int i = 1; i < MAX_KEYFRAMES; i++)
+    // The builder rebinds its own constant buffers, put the preview's back
+    cellManager.bindSimulationConstants();
+}
+
+void UIManager::updateKeyframeBuild(CellManager& cellManager)
+{
+    if (!keyframeBuild.active)
+        return;
+    
+    // Keyframes were invalidated (e.g. genome edit) while building
+    if (!keyframesInitialized || !keyframeCellManager)
     {
-        float targetTime = i * timeInterval;
-        float currentSimTime = (i - 1) * timeInterval;
+        keyframeBuild.active = false;
+        return;
+    }
+    
+    CellManager& builder = *keyframeCellManager;
+    auto sliceStart = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<double, std::milli>(config::KEYFRAME_BUILD_BUDGET_MS);
+    
+    // A pending genome resimulation needs the build to stop exactly at its target time
+    float stopTime = maxTime;
+    if (genomeResimulation.active && genomeResimulation.targetTime >= keyframeBuild.simulatedTime)
+    {
+        stopTime = std::min(stopTime, genomeResimulation.targetTime);
+    }
+    
+    // Simulate until this frame's budget is used up (keeping the original scrub time step)
+    while (keyframeBuild.simulatedTime < stopTime && std::chrono::steady_clock::now() - sliceStart < budget)
+    {
+        float timeToSimulate = stopTime - keyframeBuild.simulatedTime;
+        float stepTime = (timeToSimulate > config::scrubTimeStep) ? config::scrubTimeStep : timeToSimulate;
+        builder.updateCells(stepTime);
+        keyframeBuild.simulatedTime += stepTime;
         
-        // Simulate from previous keyframe to current keyframe
-        float timeToSimulate = targetTime - currentSimTime;
-        float scrubTimeStep = config::scrubTimeStep;
+        // The scrubber replays at physicsTimeStep, so that is what a keyframe saves
+        keyframeBuild.replayCellSteps += static_cast<double>(builder.getCellCount()) * (stepTime / config::physicsTimeStep);
         
-        while (timeToSimulate > 0.0f)
+        // Capture a keyframe once replaying from the previous one would cost more than the budget.
+        // Early keyframes (few cells) end up far apart in time, late ones close together.
+        if (keyframeBuild.replayCellSteps >= keyframeBuild.cellStepBudget)
         {
-            float stepTime = (timeToSimulate > scrubTimeStep) ? scrubTimeStep : timeToSimulate;
-            cellManager.updateCells(stepTime);
-            timeToSimulate -= stepTime;
+            // Out of keyframes before maxTime: keep every second one and double the budget,
+            // so the rest of the timeline is still covered (the last kept one is about a budget behind)
+            if (keyframes.size() >= MAX_KEYFRAMES)
+            {
+                keyframes.thin();
+                keyframeBuild.cellStepBudget *= 2.0;
+            }
+            captureKeyframe(builder, keyframeBuild.simulatedTime, static_cast<int>(keyframes.size()));
+            keyframeBuild.replayCellSteps = 0.0;
         }
-        
-        // Capture keyframe
-        captureKeyframe(cellManager, targetTime, i);
     }
     
-    keyframesInitialized = true;
-    // Check for potential timing accuracy issues with keyframe intervals
-    checkKeyframeTimingAccuracy();
+    if (keyframeBuild.simulatedTime >= maxTime)
+    {
+        keyframeBuild.active = false;
+        // Check for potential timing accuracy issues with keyframe intervals
+        checkKeyframeTimingAccuracy();
+    }
+    
+    cellManager.bindSimulationConstants();
+}
 
-    // Restore time slider position and trigger simulation reset to that time
-    currentTime = std::max(0.0f, std::min(savedCurrentTime, maxTime));
-    targetTime = currentTime;
-    needsSimulationReset = true;
-    isScrubbingTime = true;
+int UIManager::findFirstAffectedKeyframe() const
+{
+    const GenomeData& previous = keyframes.getGenome();
+    if (previous.initialMode != currentGenome.initialMode || previous.initialOrientation != currentGenome.initialOrientation)
+        return 0;
+    
+    // Modes whose simulation settings changed, compared in the form the shaders see (colour only affects rendering)
+    int modeCount = static_cast<int>(std::max(previous.modes.size(), currentGenome.modes.size()));
+    std::vector<uint32_t> changedModes((modeCount + 31) / 32, 0u);
+    bool anyChanged = false;
+    for (int i = 0; i < modeCount; i++)
+    {
+        bool changed = i >= static_cast<int>(previous.modes.size()) || i >= static_cast<int>(currentGenome.modes.size());
+        if (!changed)
+        {
+            GPUMode before = toGPUMode(previous.modes[i], 0);
+            GPUMode after = toGPUMode(currentGenome.modes[i], 0);
+            after.color = before.color;
+            changed = !(before == after);
+        }
+        if (changed)
+        {
+            changedModes[i >> 5] |= 1u << (i & 31);
+            anyChanged = true;
+        }
+    }
+    if (!anyChanged)
+        return -1;
+    
+    // A keyframe is still valid if no cell had been in an edited mode by its time
+    for (int k = 0; k < static_cast<int>(keyframes.size()); k++)
+    {
+        const std::vector<uint32_t>& reached = keyframes[k].reachedModes;
+        for (size_t w = 0; w < reached.size() && w < changedModes.size(); w++)
+        {
+            if (reached[w] & changedModes[w])
+                return k;
+        }
+    }
+    return static_cast<int>(keyframes.size());
+}
+
+void UIManager::resumeKeyframeBuild(CellManager& cellManager, int keepCount)
+{
+    if (keepCount <= 0 || !keyframeCellManager)
+    {
+        initializeKeyframes(cellManager);
+        return;
+    }
+    
+    // Drop the affected keyframes and the arena space they used
+    keyframes.truncate(keepCount);
+    int arenaSlots = 0;
+    for (int k = 0; k < keepCount; k++)
+    {
+        if (keyframes[k].gpuSlot >= 0)
+            arenaSlots = keyframes[k].gpuSlot + 1;
+    }
+    keyframeArena.truncate(arenaSlots);
+    keyframes.setGenome(currentGenome);
+    
+    // Continue the build from the last kept keyframe with the new genome
+    CellManager& builder = *keyframeCellManager;
+    const KeyframeStore::Keyframe& lastKept = keyframes[keepCount - 1];
+    restoreFromKeyframe(builder, keepCount - 1);
+    builder.setReachedModes(lastKept.reachedModes);
+    
+    keyframeBuild.active = true;
+    keyframeBuild.simulatedTime = lastKept.time;
+    keyframeBuild.replayCellSteps = 0.0;
+    keyframeBuild.cellStepBudget = static_cast<double>(config::KEYFRAME_REPLAY_STEPS) * std::max(1, builder.getCellLimit());
+    
+    cellManager.bindSimulationConstants();
+}
+
+void UIManager::updateGenomeResimulation(CellManager& cellManager, SceneManager& sceneManager)
+{
+    // Start the job once edits have settled
+    if (genomeResimulation.pending)
+    {
+        auto sinceEdit = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - genomeResimulation.lastEdit);
+        if (sinceEdit.count() < config::GENOME_RESIM_DEBOUNCE_MS)
+            return;
+        genomeResimulation.pending = false;
+        
+        // Keyframes recorded which modes had been reached, so only history that touched an edited mode is redone
+        int firstAffectedKeyframe = keyframesInitialized ? findFirstAffectedKeyframe() : 0;
+        if (keyframesInitialized && firstAffectedKeyframe < 0)
+        {
+            // Nothing the simulation uses changed (e.g. a colour), just upload the new genome
+            keyframes.setGenome(currentGenome);
+            cellManager.addGenomeToBuffer(currentGenome);
+            return;
+        }
+        
+        if (keyframesInitialized)
+            resumeKeyframeBuild(cellManager, firstAffectedKeyframe);
+        else
+            initializeKeyframes(cellManager);
+        
+        // The build restarts at the last unaffected keyframe. If the preview is before that,
+        // its history didn't involve any edited mode and only the genome needs updating.
+        if (currentTime < keyframeBuild.simulatedTime)
+        {
+            cellManager.addGenomeToBuffer(currentGenome);
+            return;
+        }
+        
+        genomeResimulation.active = true;
+        genomeResimulation.targetTime = std::min(currentTime, maxTime);
+        std::cout << "Genome changed - resimulating from " << keyframeBuild.simulatedTime << "s to " << genomeResimulation.targetTime << "s\n";
+    }
+    
+    // The build stopped short of the target (invalidated, or maxTime was lowered): the job can't finish,
+    // so the preview keeps its state and just takes the new genome instead of waiting forever
+    if (genomeResimulation.active && (!keyframeCellManager ||
+        (!keyframeBuild.active && keyframeBuild.simulatedTime < std::min(genomeResimulation.targetTime, maxTime))))
+    {
+        genomeResimulation.active = false;
+        cellManager.addGenomeToBuffer(currentGenome);
+        std::cout << "Genome resimulation cancelled - the keyframe build stopped at " << keyframeBuild.simulatedTime << "s\n";
+        return;
+    }
+    
+    // Hand the build's state to the preview once it reaches the target time
+    if (genomeResimulation.active && keyframeBuild.simulatedTime >= std::min(genomeResimulation.targetTime, maxTime))
+    {
+        genomeResimulation.active = false;
+        
+        cellManager.resetSimulation();
+        cellManager.addGenomeToBuffer(currentGenome);
+        cellManager.copyStateFrom(*keyframeCellManager);
+        if (cellManager.getCellCount() > 0)
+        {
+            cellManager.updateSpatialGrid();
+        }
+        
+        sceneManager.resetPreviewSimulationTime();
+        sceneManager.setPreviewSimulationTime(keyframeBuild.simulatedTime);
+        cellManager.bindSimulationConstants();
+    }
 }
 
 void UIManager::updateKeyframes(CellManager& cellManager, float newMaxTime)
 {
-    // Save current time slider position
-    float savedCurrentTime = currentTime;
-    float savedTargetTime = targetTime;
     maxTime = newMaxTime;
     keyframesInitialized = false;
     initializeKeyframes(cellManager);
-    // Restore time slider position and trigger simulation reset to that time
-    currentTime = std::max(0.0f, std::min(savedCurrentTime, maxTime));
-    targetTime = currentTime;
-    needsSimulationReset = true;
-    isScrubbingTime = true;
+    // Keep the time slider inside the new range
+    currentTime = std::max(0.0f, std::min(currentTime, maxTime));
 }
 
 int UIManager::findNearestKeyframe(float targetTime) const
@@ -88,17 +273,22 @@ int UIManager::findNearestKeyframe(float targetTime) const
     // Clamp target time to valid range
     targetTime = std::max(0.0f, std::min(targetTime, maxTime));
     
-    // Calculate which keyframe index should contain this time
-    float timeInterval = maxTime / (MAX_KEYFRAMES - 1);
-    int idealIndex = static_cast<int>(targetTime / timeInterval);
-    
-    // Clamp to valid keyframe range
-    idealIndex = std::max(0, std::min(idealIndex, MAX_KEYFRAMES - 1));
+    // Keyframes are unevenly spaced but sorted by time: find the last one at or before the target
+    int low = 0;
+    int high = static_cast<int>(keyframes.size()) - 1;
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+        if (keyframes[mid].time <= targetTime)
+            low = mid;
+        else
+            high = mid - 1;
+    }
     
-    // Find the nearest valid keyframe at or before the ideal index
-    for (int i = idealIndex; i >= 0; i--)
+    // Find the nearest valid keyframe at or before that index
+    for (int i = low; i >= 0; i--)
     {
-        if (i < keyframes.size() && keyframes[i].isValid)
+        if (keyframes[i].isValid)
         {
             return i;
         }
@@ -110,49 +300,61 @@ int UIManager::findNearestKeyframe(float targetTime) const
 
 void UIManager::restoreFromKeyframe(CellManager& cellManager, int keyframeIndex)
 {
-    if (keyframeIndex < 0 || keyframeIndex >= keyframes.size() || !keyframes[keyframeIndex].isValid)
+    if (keyframeIndex < 0 || keyframeIndex >= static_cast<int>(keyframes.size()) || !keyframes[keyframeIndex].isValid)
         return;
-    
-
+    const KeyframeStore::Keyframe& keyframe = keyframes[keyframeIndex];
     
     // Reset simulation (this clears adhesion connections)
     cellManager.resetSimulation();
     
     // Restore genome (make a non-const copy)
-    GenomeData genomeCopy = keyframes[keyframeIndex].genome;
+    GenomeData genomeCopy = keyframes.getGenome();
     cellManager.addGenomeToBuffer(genomeCopy);
     
+    // GPU-resident keyframe: buffer-to-buffer copies only, no readback for verification
+    if (keyframe.gpuSlot >= 0)
+    {
+        keyframeArena.restore(keyframe.gpuSlot, cellManager);
+        if (keyframe.cellCount > 0) {
+            cellManager.updateSpatialGrid();
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+        return;
+    }
+    
+    // Decode the keyframe from its full base and the deltas after it
+    std::vector<ComputeCell> cellStates;
+    std::vector<AdhesionConnection> adhesionConnections;
+    if (!keyframes.restore(keyframeIndex, cellStates, adhesionConnections))
+        return;
+    
     // CRITICAL FIX: Use direct restoration method that bypasses addition buffer system
-    if (keyframes[keyframeIndex].cellCount > 0) {
+    if (keyframe.cellCount > 0) {
         // Restore cells directly to GPU buffer
-        cellManager.restoreCellsDirectlyToGPUBuffer(keyframes[keyframeIndex].cellStates);
-        
-        // Update CPU cell data to match GPU
-        cellManager.setCPUCellData(keyframes[keyframeIndex].cellStates);
+        cellManager.restoreCellsDirectlyToGPUBuffer(cellStates);
     }
     
     // CRITICAL FIX: Ensure proper GPU buffer synchronization
     glMemoryBarrier(GL_ALL_BARRIER_BITS);
     
     // Force update of spatial grid after restoration
-    if (keyframes[keyframeIndex].cellCount > 0) {
+    if (keyframe.cellCount > 0) {
         cellManager.updateSpatialGrid();
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     }
     
     // Restore adhesion connections AFTER cell restoration
-    if (keyframes[keyframeIndex].adhesionCount > 0) {
-        cellManager.restoreAdhesionConnections(keyframes[keyframeIndex].adhesionConnections, keyframes[keyframeIndex].adhesionCount);
+    if (keyframe.adhesionCount > 0) {
+        cellManager.restoreAdhesionConnections(adhesionConnections, keyframe.adhesionCount);
     }
     
     // Update CPU-side counts to match GPU state
-    cellManager.updateCounts();
+    cellManager.updateCounts(true);
     
     // Verify restoration by checking first cell position and age
-    if (keyframes[keyframeIndex].cellCount > 0) {
-        cellManager.syncCellPositionsFromGPU();
+    if (keyframe.cellCount > 0) {
         ComputeCell verifyCell = cellManager.getCellData(0);
-        const ComputeCell& expectedCell = keyframes[keyframeIndex].cellStates[0];
+        const ComputeCell& expectedCell = cellStates[0];
         
         float posDiff = glm::length(glm::vec3(verifyCell.positionAndMass) - glm::vec3(expectedCell.positionAndMass));
         float ageDiff = abs(verifyCell.age - expectedCell.age);
@@ -175,47 +377,35 @@ void UIManager::restoreFromKeyframe(CellManager& cellManager, int keyframeIndex)
 
 void UIManager::captureKeyframe(CellManager& cellManager, float time, int keyframeIndex)
 {
-    if (keyframeIndex < 0 || keyframeIndex >= MAX_KEYFRAMES)
+    // Keyframes are stored as deltas against the previous one, so they have to be captured in order
+    if (keyframeIndex < 0 || keyframeIndex >= MAX_KEYFRAMES || keyframeIndex != static_cast<int>(keyframes.size()))
     {
         std::cerr << "Invalid keyframe index for capture: " << keyframeIndex << "\n";
         return;
     }
     
-    // Ensure keyframes vector is large enough
-    if (keyframeIndex >= keyframes.size())
-    {
-        keyframes.resize(keyframeIndex + 1);
-    }
-    
-    SimulationKeyframe& keyframe = keyframes[keyframeIndex];
-    
     // CRITICAL FIX: Ensure all GPU operations are complete before capturing state
     glMemoryBarrier(GL_ALL_BARRIER_BITS);
     // Use targeted barrier instead of glFinish() to avoid pixel transfer synchronization warning
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
     
-    // Capture current simulation state
-    keyframe.time = time;
-    keyframe.genome = currentGenome;
-    keyframe.cellCount = cellManager.getCellCount();
-    
-    // Sync cell data from GPU to CPU to ensure we have latest state
-    cellManager.syncCellPositionsFromGPU();
+    cellManager.updateCounts(true); // Exact counts, the regular ones can be a few ticks old
+    int cellCount = cellManager.getCellCount();
+    std::vector<uint32_t> reachedModes = cellManager.getReachedModes(static_cast<int>(keyframes.getGenome().modes.size()));
     
-    // Copy cell states
-    keyframe.cellStates.clear();
-    keyframe.cellStates.reserve(keyframe.cellCount);
-    
-    for (int i = 0; i < keyframe.cellCount; i++)
+    // Preview-scale states are kept in VRAM and never read back
+    int gpuSlot = keyframeArena.capture(cellManager);
+    if (gpuSlot >= 0)
     {
-        keyframe.cellStates.push_back(cellManager.getCellData(i));
+        keyframes.appendGPU(time, cellCount, cellManager.adhesionCount, gpuSlot, reachedModes);
+        return;
     }
     
-    // Capture adhesion connections
-    keyframe.adhesionConnections = cellManager.getAdhesionConnections();
-    keyframe.adhesionCount = static_cast<int>(keyframe.adhesionConnections.size());
+    // Read the cell states back from the GPU
+    std::vector<ComputeCell> cellStates = cellManager.readCells(0, cellCount);
     
-    keyframe.isValid = true;
+    // Capture adhesion connections and encode everything against the previous keyframe
+    keyframes.append(time, cellStates, cellManager.getAdhesionConnections(), reachedModes);
 }
 
 void UIManager::checkKeyframeTimingAccuracy()
@@ -232,8 +422,11 @@ void UIManager::checkKeyframeTimingAccuracy()
         }
     }
     
-    // Calculate keyframe interval
-    float keyframeInterval = maxTime / (MAX_KEYFRAMES - 1);
+    // Largest gap between keyframes (they are placed by cost, not evenly)
+    float keyframeInterval = 0.0f;
+    for (size_t i = 1; i < keyframes.size(); i++) {
+        keyframeInterval = std::max(keyframeInterval, keyframes[i].time - keyframes[i - 1].time);
+    }
     
     // Check if keyframe intervals are too large compared to split timing
     float timingRatio = keyframeInterval / shortestSplitInterval;
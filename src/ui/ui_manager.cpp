@@ -52,7 +52,11 @@ void UIManager::renderCellInspector(CellManager &cellManager, SceneManager& scen
         ImGui::Text("Velocity: (%.2f, %.2f, %.2f)", velocity.x, velocity.y, velocity.z);
         ImGui::Text("Mass: %.2f", mass);
         //ImGui::Text("Radius: %.2f", radius);
-        ImGui::Text("Absolute Mode Index: %i", modeIndex);
+        ImGui::Text("Absolute Mode Index: %i", selectedCell.cellData.genomeOffset + modeIndex);
+        if (selectedCell.cellData.simulationId != 0)
+        {
+            ImGui::Text("Ensemble Simulation: %i", selectedCell.cellData.simulationId);
+        }
         ImGui::Text("Age: %.2f", age);
 
         ImGui::Separator();
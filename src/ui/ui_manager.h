@@ -2,9 +2,16 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <memory>
+#include <chrono>
 #include <glm/glm.hpp>
 #include "../rendering/camera/camera.h"
 #include "../simulation/cell/common_structs.h"
+#include "../simulation/cell/keyframe_store.h"
+#include "../simulation/cell/keyframe_arena.h"
+#include "../simulation/cell/trajectory_recorder.h"
+#include "../simulation/cell/trajectory_player.h"
+#include "../simulation/cell/simulation_ensemble.h"
 
 // Forward declarations
 struct CellManager; // Forward declaration to avoid circular dependency
@@ -46,9 +53,12 @@ struct PerformanceMonitor
     std::vector<float> fpsHistory;
     static constexpr int HISTORY_SIZE = 120; // 2 seconds at 60fps
 
-    // GPU metrics
-    float gpuMemoryUsed = 0.0f;
-    float gpuMemoryTotal = 0.0f;
+    // GPU metrics (MB)
+    float gpuMemoryUsed = 0.0f;          // Held by the preview, main and keyframe builder simulations' buffer arenas
+    float gpuMemoryTotal = 0.0f;         // Driver-reported video memory (0 if the driver doesn't say)
+    float gpuMemoryAvailable = 0.0f;     // Driver-reported free video memory
+    bool gpuMemoryReported = false;      // GL_NVX_gpu_memory_info or GL_ATI_meminfo is available
+    const char* gpuMemorySource = "";
     int drawCalls = 0;
     int vertices = 0;
 
@@ -66,6 +76,8 @@ struct PerformanceMonitor
 class UIManager
 {
 public:
+    ~UIManager();
+
     void renderCellInspector(CellManager &cellManager, SceneManager& sceneManager);
     void renderPerformanceMonitor(CellManager &cellManager, PerformanceMonitor &perfMonitor, SceneManager& sceneManager);
     void renderCameraControls(CellManager &cellmanager, Camera &camera, SceneManager& sceneManager);
@@ -102,6 +114,13 @@ public:
     
     // Distance-based culling and fading toggle
     bool enableDistanceCulling = true;   // Toggle for distance-based culling and fading
+    
+    // Main simulation trajectory recording and playback (controlled from the Scene Manager window)
+    TrajectoryRecorder trajectoryRecorder;
+    TrajectoryPlayer trajectoryPlayer;   // While open, the main scene shows the recording instead of simulating
+
+    // Simulation the scrubbing keyframes are built on, null until the first build
+    const CellManager* getKeyframeCellManager() const { return keyframeCellManager.get(); }
 
 private:    // Helper to get window flags based on lock state
     int getWindowFlags(int baseFlags = 0) const;
@@ -119,7 +138,17 @@ private:    // Helper to get window flags based on lock state
     void validateGenomeColors(); // Validate and fix color values in genome
     void addTooltip(const char* tooltip); // Helper to add question mark tooltips
     bool isColorBright(const glm::vec3 &color); // Helper to determine if color is bright    // Genome Editor Data
-    int selectedModeIndex = 0;    // Time Scrubber Data
+    int selectedModeIndex = 0;
+    char checkpointPathBuffer[256] = "checkpoints/main.bcp"; // Checkpoint file used by the Scene Manager window
+    char trajectoryPathBuffer[256] = "trajectories/main.btr";
+    std::string playbackError; // Shown under the playback controls, e.g. when the parked simulation couldn't be restored
+    int trajectoryRecordInterval = config::TRAJECTORY_RECORD_INTERVAL;
+    // Parameter sweep ensemble for the main simulation
+    SimulationEnsemble simulationEnsemble;
+    SimulationEnsemble::Sweep ensembleSweep;
+    int ensembleSize = 27;
+    int ensembleCountRefreshFrames = 0;
+    // Time Scrubber Data
     float currentTime = 0.0f;
     float maxTime = 50.0f;
     char timeInputBuffer[32] = "0.00";
@@ -128,22 +157,40 @@ private:    // Helper to get window flags based on lock state
     bool needsSimulationReset = false;  // Flag to reset simulation when scrubber changes
     bool isScrubbingTime = false;       // Flag to indicate we're scrubbing to a specific time
     
-    // Keyframe system for efficient time scrubbing
-    struct SimulationKeyframe {
-        float time = 0.0f;
-        std::vector<ComputeCell> cellStates;
-        std::vector<AdhesionConnection> adhesionConnections; // Store adhesion connections
-        GenomeData genome;
-        int cellCount = 0;
-        int adhesionCount = 0; // Store adhesion count
-        bool isValid = false;
-    };
-    
+    // Keyframe system for efficient time scrubbing (delta-compressed, see KeyframeStore)
     static constexpr int MAX_KEYFRAMES = 50;
-    std::vector<SimulationKeyframe> keyframes;
+    KeyframeStore keyframes;
+    KeyframeArena keyframeArena;     // Keyframes that fit stay in VRAM, the rest are delta-compressed in `keyframes`
     bool keyframesInitialized = false;
     
+    // Keyframes are built on a separate simulation, a time slice per frame, so the preview stays interactive
+    // Keyframes are placed by replay cost (cell-steps) rather than evenly in time, since the population grows exponentially
+    struct KeyframeBuildJob {
+        bool active = false;
+        float simulatedTime = 0.0f;     // Time reached by the build simulation
+        double replayCellSteps = 0.0;   // Cost of replaying from the last keyframe to simulatedTime (cells x physics steps)
+        double cellStepBudget = 0.0;    // Replay cost at which the next keyframe is captured
+    };
+    KeyframeBuildJob keyframeBuild;
+    std::unique_ptr<CellManager> keyframeCellManager; // Created on the first build, reused afterwards
+    
     void initializeKeyframes(CellManager& cellManager);
+    void updateKeyframeBuild(CellManager& cellManager);
+    // Genome edits: keyframes whose history never reached an edited mode are kept, the build resumes after them
+    int findFirstAffectedKeyframe() const; // -1 if no edit affects the simulation (e.g. colour only)
+    void resumeKeyframeBuild(CellManager& cellManager, int keepCount);
+    
+    // Genome edits are debounced, then the keyframe build simulates the new history in time slices and
+    // hands its state to the preview when it reaches the edit time. Until then the preview keeps showing
+    // the last complete state. A newer edit cancels the job.
+    struct GenomeResimulationJob {
+        bool pending = false;       // Edited, waiting for the debounce interval
+        bool active = false;        // Waiting for the keyframe build to reach targetTime
+        float targetTime = 0.0f;
+        std::chrono::steady_clock::time_point lastEdit;
+    };
+    GenomeResimulationJob genomeResimulation;
+    void updateGenomeResimulation(CellManager& cellManager, SceneManager& sceneManager);
     void updateKeyframes(CellManager& cellManager, float newMaxTime);
     int findNearestKeyframe(float targetTime) const;
     void restoreFromKeyframe(CellManager& cellManager, int keyframeIndex);
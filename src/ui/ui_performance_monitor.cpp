@@ -180,18 +180,70 @@ void UIManager::renderPerformanceMonitor(CellManager &cellManager, PerformanceMo
     ImGui::Separator();
 
     int cellCount = cellManager.getCellCount();
-    ImGui::Text("Active Cells: %i / %i", cellCount, config::MAX_CELLS);
+    ImGui::Text("Active Cells: %i / %i", cellCount, cellManager.getCellLimit());
+    ImGui::Text("Buffer Capacity: %i cells", cellManager.getCellCapacity());
     ImGui::Text("Pending Cells: %i", cellManager.pendingCellCount);
-    ImGui::Text("Adhesion Connections: %i / %i", cellManager.adhesionCount, config::MAX_ADHESIONS);
+    ImGui::Text("Adhesion Connections: %i / %i", cellManager.adhesionCount, cellManager.getCellCapacity());
     ImGui::Text("Triangles: %i", cellManager.getTotalTriangleCount());
     ImGui::Text("Vertices: %i", cellManager.getTotalVertexCount());
 
-    // Memory estimate
-    float memoryMB = (cellCount * sizeof(ComputeCell)) / (1024.0f * 1024.0f);
-    ImGui::Text("Cell Data Memory: %.2f MB", memoryMB);
+    // GPU memory held by this simulation, as allocated by its buffer arena
+    GPUBufferArena &arena = cellManager.bufferArena;
+    if (arena.getBudget() > 0)
+        ImGui::Text("GPU Memory: %.2f / %.0f MB", arena.getTotalBytes() / (1024.0f * 1024.0f), arena.getBudget() / (1024.0f * 1024.0f));
+    else
+        ImGui::Text("GPU Memory: %.2f MB", arena.getTotalBytes() / (1024.0f * 1024.0f));
+    ImGui::Text("All Simulations: %.2f MB", perfMonitor.gpuMemoryUsed);
+    if (perfMonitor.gpuMemoryReported)
+    {
+        if (perfMonitor.gpuMemoryTotal > 0.0f)
+            ImGui::Text("Driver: %.0f MB free of %.0f MB (%s)", perfMonitor.gpuMemoryAvailable, perfMonitor.gpuMemoryTotal, perfMonitor.gpuMemorySource);
+        else
+            ImGui::Text("Driver: %.0f MB free (%s)", perfMonitor.gpuMemoryAvailable, perfMonitor.gpuMemorySource);
+    }
+    else
+    {
+        ImGui::TextDisabled("Driver memory info not available");
+    }
+
+    int budgetMB = static_cast<int>(arena.getBudget() / (1024 * 1024));
+    if (ImGui::InputInt("GPU Budget (MB)", &budgetMB, 256, 1024))
+    {
+        arena.setBudget(static_cast<size_t>(std::max(budgetMB, 0)) * 1024 * 1024);
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Most GPU memory this simulation may allocate (0 = unlimited).\nThe cell buffers stop growing once they would exceed it.");
+    if (ImGui::TreeNode("Memory by Subsystem"))
+    {
+        for (int i = 0; i < static_cast<int>(GPUSubsystem::Count); i++)
+        {
+            GPUSubsystem subsystem = static_cast<GPUSubsystem>(i);
+            ImGui::Text("%-12s %8.2f MB  (%d buffers)", getGPUSubsystemName(subsystem),
+                arena.getSubsystemBytes(subsystem) / (1024.0f * 1024.0f), arena.getSubsystemBufferCount(subsystem));
+        }
+        const ReadbackPool& pool = cellManager.readbackPool;
+        ImGui::Text("Readback pool: %d idle buffers, %.2f MB, %d created", pool.getIdleBufferCount(),
+            pool.getIdleBytes() / (1024.0f * 1024.0f), pool.getAllocationCount());
+        ImGui::TreePop();
+    }
 
     // === Performance Warnings ===
     ImGui::Spacing();
+    size_t limitBytes = cellManager.estimateGPUBytes(cellManager.getCellLimit());
+    if (arena.getBudget() > 0 && limitBytes > arena.getBudget())
+    {
+        ImGui::TextColored(ImVec4(1, 0.5f, 0, 1), "⚠ Cell limit over GPU budget!");
+        ImGui::TextWrapped("A cell limit of %i needs about %.0f MB, the budget is %.0f MB. The cell buffers will stop growing before the limit is reached.",
+            cellManager.getCellLimit(), limitBytes / (1024.0f * 1024.0f), arena.getBudget() / (1024.0f * 1024.0f));
+    }
+    // Growing needs the new buffers before the old ones are freed, so compare the growth against what's free
+    size_t growthBytes = limitBytes > arena.getTotalBytes() ? limitBytes - arena.getTotalBytes() : 0;
+    if (perfMonitor.gpuMemoryReported && growthBytes / (1024.0f * 1024.0f) > perfMonitor.gpuMemoryAvailable)
+    {
+        ImGui::TextColored(ImVec4(1, 0, 0, 1), "⚠ Cell limit over free GPU memory!");
+        ImGui::TextWrapped("Reaching %i cells needs %.0f MB more, the driver reports %.0f MB free.",
+            cellManager.getCellLimit(), growthBytes / (1024.0f * 1024.0f), perfMonitor.gpuMemoryAvailable);
+    }
     if (perfMonitor.displayFPS < 30.0f)
     {
         ImGui::TextColored(ImVec4(1, 0, 0, 1), "⚠ Low FPS detected!");
@@ -220,8 +272,12 @@ void UIManager::renderPerformanceMonitor(CellManager &cellManager, PerformanceMo
             ImGui::Text("LOD 1 (16x16): %d cells", lodCounts[1]);
             ImGui::Text("LOD 2 (8x8):   %d cells", lodCounts[2]);
             ImGui::Text("LOD 3 (4x4):   %d cells", lodCounts[3]);
+            ImGui::Text("LOD 4 (impostor): %d cells", lodCounts[CellManager::IMPOSTOR_LOD_LEVEL]);
             
-            int totalLodCells = lodCounts[0] + lodCounts[1] + lodCounts[2] + lodCounts[3];
+            int totalLodCells = 0;
+            for (int i = 0; i < CellManager::UNIFIED_LOD_LEVELS; i++) {
+                totalLodCells += lodCounts[i];
+            }
             if (totalLodCells > 0) {
                 ImGui::Text("LOD Coverage: %d / %d cells (%.1f%%)", 
                     totalLodCells, cellCount, 
@@ -1,5 +1,6 @@
 #include "ui_manager.h"
 #include "../simulation/cell/cell_manager.h"
+#include "../simulation/cell/simulation_checkpoint.h"
 #include "../core/config.h"
 #include "imgui.h"
 #include <algorithm>
@@ -8,6 +9,7 @@
 #include <cstdlib>
 #include <cstdio>
 #include <iostream>
+#include <filesystem>
 
 #include "../audio/audio_engine.h"
 #include "../scene/scene_manager.h"
@@ -20,6 +22,12 @@
 #undef max
 #endif
 
+namespace
+{
+    // Where the main simulation waits while a trajectory is being played back
+    constexpr const char* PLAYBACK_PARKED_CHECKPOINT = "checkpoints/before_playback.bcp";
+}
+
 void UIManager::renderSceneSwitcher(SceneManager& sceneManager, CellManager& previewCellManager, CellManager& mainCellManager)
 {
     // Set window position on first use - top center
@@ -67,6 +75,7 @@ void UIManager::renderSceneSwitcher(SceneManager& sceneManager, CellManager& pre
             if (ImGui::Button("Reset Main", ImVec2(150, 30)))
             {
                 mainCellManager.resetSimulation();
+                simulationEnsemble.clear();
                 mainCellManager.addGenomeToBuffer(currentGenome);
                 ComputeCell newCell{};
                 newCell.modeIndex = currentGenome.initialMode;
@@ -75,8 +84,215 @@ void UIManager::renderSceneSwitcher(SceneManager& sceneManager, CellManager& pre
                 
                 // Advance simulation by one frame after reset
                 mainCellManager.updateCells(config::physicsTimeStep);
+                sceneManager.setMainSimulationTime(0.0);
             }
             ImGui::PopStyleColor();
+            
+            // Cell limit of the main scene (buffers grow towards it as the population does)
+            int mainCellLimit = sceneManager.getCellLimit(Scene::MainSimulation);
+            ImGui::PushItemWidth(150.0f);
+            if (ImGui::InputInt("Cell Limit", &mainCellLimit, 10000, 100000))
+            {
+                sceneManager.setCellLimit(Scene::MainSimulation, std::clamp(mainCellLimit, 1, config::MAX_CELL_LIMIT));
+            }
+            ImGui::PopItemWidth();
+            addTooltip("Most cells the main simulation may hold. GPU buffers are only allocated as the population grows");
+            
+            // Populations of different genomes: each added genome gets its own slots in the mode table
+            ImGui::BeginDisabled(simulationEnsemble.isActive());
+            if (ImGui::Button("Add Current Genome", ImVec2(150, 25)))
+            {
+                int genomeId = mainCellManager.addGenome(currentGenome);
+                if (genomeId >= 0)
+                {
+                    ComputeCell newCell{};
+                    newCell.positionAndMass = glm::vec4(
+                        (static_cast<float>(rand()) / RAND_MAX - 0.5f) * config::WORLD_SIZE * 0.5f,
+                        (static_cast<float>(rand()) / RAND_MAX - 0.5f) * config::WORLD_SIZE * 0.5f,
+                        (static_cast<float>(rand()) / RAND_MAX - 0.5f) * config::WORLD_SIZE * 0.5f, 1.0f);
+                    newCell.orientation = currentGenome.initialOrientation;
+                    newCell.modeIndex = currentGenome.initialMode;
+                    newCell.genomeOffset = mainCellManager.genomeTable.getModeOffset(genomeId);
+                    mainCellManager.addCellToStagingBuffer(newCell);
+                }
+            }
+            ImGui::EndDisabled();
+            addTooltip("Adds the genome being edited to the main simulation alongside the ones already there, starting from one cell at a random position");
+            ImGui::SameLine();
+            ImGui::TextDisabled("%d genomes, %d modes", mainCellManager.genomeTable.getGenomeCount(), mainCellManager.genomeTable.getModeCount());
+            
+            // Checkpoints
+            ImGui::PushItemWidth(305.0f);
+            ImGui::InputText("##CheckpointPath", checkpointPathBuffer, sizeof(checkpointPathBuffer));
+            ImGui::PopItemWidth();
+            if (ImGui::Button("Save Checkpoint", ImVec2(150, 25)))
+            {
+                saveCheckpoint(checkpointPathBuffer, mainCellManager, sceneManager.getMainSimulationTime());
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Load Checkpoint", ImVec2(150, 25)))
+            {
+                double loadedTime = 0.0;
+                if (loadCheckpoint(checkpointPathBuffer, mainCellManager, currentGenome, loadedTime))
+                {
+                    simulationEnsemble.clear();
+                    sceneManager.setMainSimulationTime(loadedTime);
+                    genomeChanged = true; // The preview follows the loaded genome
+                }
+            }
+            
+            // Parameter sweep: many copies of the current genome with one parameter varied, simulated side by side
+            if (ImGui::CollapsingHeader("Parameter Sweep"))
+            {
+                ImGui::PushItemWidth(200.0f);
+                ImGui::SliderInt("Simulations", &ensembleSize, 1, config::ENSEMBLE_MAX_SIMULATIONS);
+                int sweepMode = std::clamp(ensembleSweep.modeIndex, 0, static_cast<int>(currentGenome.modes.size()) - 1);
+                ImGui::SliderInt("Mode", &sweepMode, 0, static_cast<int>(currentGenome.modes.size()) - 1);
+                ensembleSweep.modeIndex = sweepMode;
+                int parameter = static_cast<int>(ensembleSweep.parameter);
+                if (ImGui::BeginCombo("Parameter", getEnsembleParameterName(ensembleSweep.parameter)))
+                {
+                    for (int i = 0; i < static_cast<int>(EnsembleParameter::Count); i++)
+                    {
+                        if (ImGui::Selectable(getEnsembleParameterName(static_cast<EnsembleParameter>(i)), parameter == i))
+                        {
+                            ensembleSweep.parameter = static_cast<EnsembleParameter>(i);
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+                ImGui::DragFloatRange2("Range", &ensembleSweep.from, &ensembleSweep.to, 0.05f);
+                ImGui::PopItemWidth();
+                if (ImGui::Button("Run Sweep", ImVec2(150, 25)))
+                {
+                    trajectoryRecorder.stop();
+                    if (simulationEnsemble.startSweep(mainCellManager, currentGenome, ensembleSweep, ensembleSize))
+                    {
+                        sceneManager.setMainSimulationTime(0.0);
+                    }
+                }
+                addTooltip("Restarts the main simulation as one independent simulation per variant, each in its own block of the world");
+
+                if (simulationEnsemble.isActive())
+                {
+                    // The counters are a small synchronous readback, so only refresh them a few times per second
+                    if (--ensembleCountRefreshFrames <= 0)
+                    {
+                        simulationEnsemble.refreshCellCounts(mainCellManager);
+                        ensembleCountRefreshFrames = 15;
+                    }
+                    const std::vector<float>& counts = simulationEnsemble.getCellCounts();
+                    const std::vector<float>& values = simulationEnsemble.getSweepValues();
+                    ImGui::PlotHistogram("##EnsembleCounts", counts.data(), static_cast<int>(counts.size()), 0,
+                        "cells per simulation", 0.0f, static_cast<float>(simulationEnsemble.getCellsPerSimulation()), ImVec2(305, 80));
+                    if (ImGui::IsItemHovered() && !counts.empty())
+                    {
+                        float hoverX = (ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+                        int i = std::clamp(static_cast<int>(hoverX * counts.size()), 0, static_cast<int>(counts.size()) - 1);
+                        ImGui::SetTooltip("#%d  %s = %.3f  %.0f cells", i, getEnsembleParameterName(ensembleSweep.parameter),
+                            i < static_cast<int>(values.size()) ? values[i] : 0.0f, counts[i]);
+                    }
+                    ImGui::TextDisabled("%d simulations, up to %d cells each",
+                        simulationEnsemble.getSimulationCount(), simulationEnsemble.getCellsPerSimulation());
+                }
+            }
+            
+            // Trajectory recording
+            ImGui::PushItemWidth(305.0f);
+            ImGui::InputText("##TrajectoryPath", trajectoryPathBuffer, sizeof(trajectoryPathBuffer));
+            ImGui::PopItemWidth();
+            if (!trajectoryRecorder.isRecording())
+            {
+                if (ImGui::Button("Record Trajectory", ImVec2(150, 25)))
+                {
+                    trajectoryRecorder.start(trajectoryPathBuffer, mainCellManager, TRAJECTORY_FIELD_ALL, trajectoryRecordInterval);
+                }
+                ImGui::SameLine();
+                ImGui::PushItemWidth(150.0f);
+                ImGui::SliderInt("##RecordInterval", &trajectoryRecordInterval, 1, 100, "every %d ticks");
+                ImGui::PopItemWidth();
+            }
+            else
+            {
+                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7f, 0.3f, 0.3f, 1.0f));
+                if (ImGui::Button("Stop Recording", ImVec2(150, 25)))
+                {
+                    trajectoryRecorder.stop();
+                }
+                ImGui::PopStyleColor();
+            }
+            TrajectoryRecorder::Stats recordStats = trajectoryRecorder.getStats();
+            if (recordStats.framesWritten > 0 || trajectoryRecorder.isRecording())
+            {
+                float ratio = recordStats.encodedBytes > 0 ? static_cast<float>(recordStats.rawBytes) / recordStats.encodedBytes : 0.0f;
+                ImGui::TextDisabled("%llu frames (%llu dropped), %.1f MB, %.1fx",
+                    static_cast<unsigned long long>(recordStats.framesWritten),
+                    static_cast<unsigned long long>(recordStats.framesDropped),
+                    recordStats.encodedBytes / (1024.0f * 1024.0f), ratio);
+            }
+            
+            // Trajectory playback (the simulation is parked in a checkpoint and restored when playback closes)
+            if (!trajectoryPlayer.isOpen())
+            {
+                if (ImGui::Button("Play Trajectory", ImVec2(150, 25)))
+                {
+                    trajectoryRecorder.stop();
+                    playbackError.clear();
+                    simulationEnsemble.refreshCellCounts(mainCellManager); // Exact counters for reattaching the ensemble
+                    if (saveCheckpoint(PLAYBACK_PARKED_CHECKPOINT, mainCellManager, sceneManager.getMainSimulationTime()) &&
+                        !trajectoryPlayer.open(trajectoryPathBuffer))
+                    {
+                        std::filesystem::remove(PLAYBACK_PARKED_CHECKPOINT);
+                    }
+                }
+                addTooltip("Replay the trajectory file above instead of simulating");
+            }
+            else
+            {
+                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7f, 0.3f, 0.3f, 1.0f));
+                if (ImGui::Button("Close Playback", ImVec2(150, 25)))
+                {
+                    trajectoryPlayer.close();
+                    double parkedTime = 0.0;
+                    GenomeData parkedGenome = currentGenome;
+                    if (loadCheckpoint(PLAYBACK_PARKED_CHECKPOINT, mainCellManager, parkedGenome, parkedTime))
+                    {
+                        simulationEnsemble.reattach(mainCellManager);
+                        sceneManager.setMainSimulationTime(parkedTime);
+                        std::filesystem::remove(PLAYBACK_PARKED_CHECKPOINT);
+                    }
+                    else
+                    {
+                        // Keep the file so the simulation can still be loaded by hand, and don't simulate the playback frame
+                        mainCellManager.resetSimulation();
+                        simulationEnsemble.clear();
+                        playbackError = std::string("Could not restore the simulation, it is kept in ") + PLAYBACK_PARKED_CHECKPOINT;
+                    }
+                }
+                ImGui::PopStyleColor();
+            }
+            if (trajectoryPlayer.isOpen())
+            {
+                ImGui::SameLine();
+                ImGui::Checkbox("Loop", &trajectoryPlayer.loop);
+                ImGui::SameLine();
+                ImGui::Checkbox("Play", &trajectoryPlayer.playing);
+                
+                // Scrubbing seeks in the file, nothing is simulated
+                float playbackTime = static_cast<float>(trajectoryPlayer.getPlaybackTime());
+                ImGui::PushItemWidth(305.0f);
+                if (ImGui::SliderFloat("##PlaybackTime", &playbackTime,
+                    static_cast<float>(trajectoryPlayer.getStartTime()), static_cast<float>(trajectoryPlayer.getEndTime()), "%.2fs"))
+                {
+                    trajectoryPlayer.setPlaybackTime(playbackTime);
+                }
+                ImGui::PopItemWidth();
+                ImGui::TextDisabled("Frame %d / %zu", trajectoryPlayer.getCurrentFrame() + 1, trajectoryPlayer.getFrameCount());
+            }
+            if (!playbackError.empty())
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", playbackError.c_str());
+            }
         }
         else if (currentScene == Scene::PreviewSimulation)
         {
@@ -139,9 +355,10 @@ void UIManager::renderSceneSwitcher(SceneManager& sceneManager, CellManager& pre
         else
         {
             bool isPaused = sceneManager.isPaused();
-            ImGui::TextDisabled("Status: %s | Speed: %.1fx", 
+            ImGui::TextDisabled("Status: %s | Speed: %.1fx | Time: %.2fs", 
                 isPaused ? "PAUSED" : "RUNNING", 
-                sceneManager.getSimulationSpeed());
+                sceneManager.getSimulationSpeed(),
+                sceneManager.getMainSimulationTime());
         }
     }
     ImGui::End();
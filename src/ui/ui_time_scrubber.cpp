@@ -23,6 +23,21 @@
 void UIManager::renderTimeScrubber(CellManager& cellManager, SceneManager& sceneManager)
 {
     cellManager.setCellLimit(sceneManager.getCurrentCellLimit());
+    // Advance the background keyframe build by one time slice
+    updateKeyframeBuild(cellManager);
+    // Handle genome changes - trigger instant resimulation (here rather than in the genome editor,
+    // so jobs still start and finish while its window is collapsed)
+    if (genomeChanged)
+    {
+        // Coalesce edits (e.g. every tick of a dragged slider) into one resimulation job
+        genomeResimulation.pending = true;
+        genomeResimulation.active = false; // A newer edit cancels the running job
+        genomeResimulation.lastEdit = std::chrono::steady_clock::now();
+        
+        // Clear the flag
+        genomeChanged = false;
+    }
+    updateGenomeResimulation(cellManager, sceneManager);
     // Set window size and position for a long horizontal resizable window
     ImGui::SetNextWindowPos(ImVec2(50, 680), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(ImVec2(800, 120), ImGuiCond_FirstUseEver);
@@ -133,9 +148,21 @@ void UIManager::renderTimeScrubber(CellManager& cellManager, SceneManager& scene
         }
         
         // Show keyframe status
-        ImGui::Text("Keyframes: %s (%d/50)", 
-                   keyframesInitialized ? "Ready" : "Not Ready", 
-                   keyframesInitialized ? MAX_KEYFRAMES : 0);
+        ImGui::Text("Keyframes: %s (%d/%d)", 
+                   !keyframesInitialized ? "Not Ready" : keyframeBuild.active ? "Building" : "Ready", 
+                   keyframesInitialized ? static_cast<int>(keyframes.size()) : 0, MAX_KEYFRAMES);
+        if (keyframesInitialized)
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("GPU %.1f KB", keyframeArena.getUsedBytes() / 1024.0f);
+            if (keyframes.getUncompressedBytes() > 0)
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("CPU %.1f KB (%.1fx smaller than full copies)",
+                    keyframes.getEncodedBytes() / 1024.0f,
+                    static_cast<float>(keyframes.getUncompressedBytes()) / keyframes.getEncodedBytes());
+            }
+        }
         
         // Initialize keyframes if not done yet
         if (!keyframesInitialized)
@@ -144,16 +171,20 @@ void UIManager::renderTimeScrubber(CellManager& cellManager, SceneManager& scene
         }        // Handle time scrubbing
         if (needsSimulationReset && isScrubbingTime)
         {
+            // Scrubbing replaces whatever a pending genome resimulation would have delivered
+            genomeResimulation.active = false;
+            
             if (keyframesInitialized)
             {
                 // Use keyframe system for efficient scrubbing
                 int nearestKeyframeIndex = findNearestKeyframe(targetTime);
-                const SimulationKeyframe& nearestKeyframe = keyframes[nearestKeyframeIndex];
-                
-
+                const KeyframeStore::Keyframe& nearestKeyframe = keyframes[nearestKeyframeIndex];
                 
                 // Restore from nearest keyframe
                 restoreFromKeyframe(cellManager, nearestKeyframeIndex);
+                // GPU-resident keyframes are never read back, so only CPU keyframes can be checked for drift
+                bool verifyAge = nearestKeyframe.gpuSlot < 0 && nearestKeyframe.cellCount > 0;
+                float keyframeCellAge = verifyAge ? cellManager.getCellData(0).age : 0.0f;
                 
                 // Reset scene manager time to keyframe time
                 sceneManager.resetPreviewSimulationTime();
@@ -181,10 +212,9 @@ void UIManager::renderTimeScrubber(CellManager& cellManager, SceneManager& scene
                     }
                     
                     // CRITICAL FIX: Verify timing accuracy after fast-forward
-                    if (nearestKeyframeIndex < keyframes.size() && keyframes[nearestKeyframeIndex].cellCount > 0) {
-                        cellManager.syncCellPositionsFromGPU();
+                    if (verifyAge) {
                         ComputeCell currentCell = cellManager.getCellData(0);
-                        float expectedAge = keyframes[nearestKeyframeIndex].cellStates[0].age + (targetTime - nearestKeyframe.time);
+                        float expectedAge = keyframeCellAge + (targetTime - nearestKeyframe.time);
                         float ageDiff = abs(currentCell.age - expectedAge);
                         
                         if (ageDiff > 0.01f) {